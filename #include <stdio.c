@@ -1,8 +1,10 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include "vetor_crescente.h"   // Mochila sem limite fixo de itens
+#include "entrada_rapida.h"    // Leitura do stdin em blocos
+#include "assinatura_nome.h"   // Tamanho + hash do nome para a igualdade
 
-#define MAX_ITENS 10   // Capacidade máxima da mochila
 #define TAM_NOME 30
 #define TAM_TIPO 20
 
@@ -13,22 +15,23 @@ typedef struct {
     char nome[TAM_NOME];
     char tipo[TAM_TIPO];
     int quantidade;
+    AssinaturaNome assinatura; // tamanho + hash do nome, calculados na insercao
 } Item;
 
 // ================================
 // Protótipos das funções
 // ================================
-void inserirItem(Item mochila[], int *qtd);
-void removerItem(Item mochila[], int *qtd);
-void listarItens(Item mochila[], int qtd);
-void buscarItem(Item mochila[], int qtd);
+void inserirItem(VetorCrescente *mochila);
+void removerItem(VetorCrescente *mochila);
+void listarItens(const VetorCrescente *mochila);
+void buscarItem(const VetorCrescente *mochila);
 
 // ================================
 // Função principal (menu do jogo)
 // ================================
 int main() {
-    Item mochila[MAX_ITENS];
-    int qtd = 0;   // número atual de itens
+    VetorCrescente mochila;   // itens + quantidade atual (mochila.tamanho)
+    vc_init(&mochila, sizeof(Item));
     int opcao;
 
     do {
@@ -39,21 +42,22 @@ int main() {
         printf("4 - Buscar item\n");
         printf("0 - Sair\n");
         printf("Escolha uma opcao: ");
-        scanf("%d", &opcao);
-        getchar(); // limpa o buffer do '\n'
+        int r = entrada_ler_int(&opcao);
+        if (r != 1) opcao = (r == EOF) ? 0 : -1; // fim da entrada encerra
+        entrada_descartar_linha(); // limpa o buffer do '\n'
 
         switch(opcao) {
             case 1:
-                inserirItem(mochila, &qtd);
+                inserirItem(&mochila);
                 break;
             case 2:
-                removerItem(mochila, &qtd);
+                removerItem(&mochila);
                 break;
             case 3:
-                listarItens(mochila, qtd);
+                listarItens(&mochila);
                 break;
             case 4:
-                buscarItem(mochila, qtd);
+                buscarItem(&mochila);
                 break;
             case 0:
                 printf("\nSaindo do sistema... Boa sorte na sua jornada!\n");
@@ -63,6 +67,7 @@ int main() {
         }
     } while(opcao != 0);
 
+    vc_liberar(&mochila);
     return 0;
 }
 
@@ -70,83 +75,78 @@ int main() {
 // Função: inserirItem()
 // Cadastra um novo item na mochila
 // ================================
-void inserirItem(Item mochila[], int *qtd) {
-    if (*qtd >= MAX_ITENS) {
-        printf("\nMochila cheia! Nao e possivel adicionar mais itens.\n");
-        return;
-    }
-
+void inserirItem(VetorCrescente *mochila) {
     Item novo;
 
     printf("\nDigite o nome do item: ");
-    fgets(novo.nome, TAM_NOME, stdin);
-    novo.nome[strcspn(novo.nome, "\n")] = '\0'; // remove \n
+    entrada_ler_linha(novo.nome, TAM_NOME); // ja sem o \n
+    novo.assinatura = assinar_nome(novo.nome);
 
     printf("Digite o tipo do item (arma, municao, cura, etc.): ");
-    fgets(novo.tipo, TAM_TIPO, stdin);
-    novo.tipo[strcspn(novo.tipo, "\n")] = '\0';
+    entrada_ler_linha(novo.tipo, TAM_TIPO);
 
     printf("Digite a quantidade: ");
-    scanf("%d", &novo.quantidade);
-    getchar();
+    entrada_ler_int(&novo.quantidade);
+    entrada_descartar_linha();
 
-    mochila[*qtd] = novo;
-    (*qtd)++;
+    if (!vc_inserir(mochila, &novo)) {
+        printf("\nMemoria insuficiente! Nao e possivel adicionar mais itens.\n");
+        return;
+    }
 
     printf("\n✅ Item adicionado com sucesso!\n");
-    listarItens(mochila, *qtd);
+    listarItens(mochila);
 }
 
 // ================================
 // Função: removerItem()
 // Remove item pelo nome informado
 // ================================
-void removerItem(Item mochila[], int *qtd) {
-    if (*qtd == 0) {
+void removerItem(VetorCrescente *mochila) {
+    if (mochila->tamanho == 0) {
         printf("\nA mochila esta vazia!\n");
         return;
     }
 
     char nomeBusca[TAM_NOME];
     printf("\nDigite o nome do item a remover: ");
-    fgets(nomeBusca, TAM_NOME, stdin);
-    nomeBusca[strcspn(nomeBusca, "\n")] = '\0';
+    entrada_ler_linha(nomeBusca, TAM_NOME);
+    AssinaturaNome an = assinar_nome(nomeBusca);
 
-    int encontrado = -1;
-    for (int i = 0; i < *qtd; i++) {
-        if (strcmp(mochila[i].nome, nomeBusca) == 0) {
+    Item *itens = VC_ITENS(mochila, Item);
+    size_t encontrado = VC_NAO_ENCONTRADO;
+    for (size_t i = 0; i < mochila->tamanho; i++) {
+        if (nome_igual(itens[i].nome, itens[i].assinatura, nomeBusca, an)) {
             encontrado = i;
             break;
         }
     }
 
-    if (encontrado != -1) {
-        for (int j = encontrado; j < *qtd - 1; j++) {
-            mochila[j] = mochila[j + 1];
-        }
-        (*qtd)--;
+    if (encontrado != VC_NAO_ENCONTRADO) {
+        vc_remover(mochila, encontrado);
         printf("\n🗑️  Item '%s' removido com sucesso!\n", nomeBusca);
     } else {
         printf("\nItem '%s' nao encontrado na mochila.\n", nomeBusca);
     }
 
-    listarItens(mochila, *qtd);
+    listarItens(mochila);
 }
 
 // ================================
 // Função: listarItens()
 // Mostra todos os itens cadastrados
 // ================================
-void listarItens(Item mochila[], int qtd) {
+void listarItens(const VetorCrescente *mochila) {
     printf("\n======= ITENS NA MOCHILA =======\n");
-    if (qtd == 0) {
+    if (mochila->tamanho == 0) {
         printf("A mochila esta vazia!\n");
         return;
     }
 
-    for (int i = 0; i < qtd; i++) {
-        printf("%d) Nome: %s | Tipo: %s | Quantidade: %d\n",
-               i + 1, mochila[i].nome, mochila[i].tipo, mochila[i].quantidade);
+    const Item *itens = VC_ITENS(mochila, const Item);
+    for (size_t i = 0; i < mochila->tamanho; i++) {
+        printf("%zu) Nome: %s | Tipo: %s | Quantidade: %d\n",
+               i + 1, itens[i].nome, itens[i].tipo, itens[i].quantidade);
     }
 }
 
@@ -154,23 +154,24 @@ void listarItens(Item mochila[], int qtd) {
 // Função: buscarItem()
 // Busca sequencial pelo nome do item
 // ================================
-void buscarItem(Item mochila[], int qtd) {
-    if (qtd == 0) {
+void buscarItem(const VetorCrescente *mochila) {
+    if (mochila->tamanho == 0) {
         printf("\nA mochila esta vazia!\n");
         return;
     }
 
     char nomeBusca[TAM_NOME];
     printf("\nDigite o nome do item para buscar: ");
-    fgets(nomeBusca, TAM_NOME, stdin);
-    nomeBusca[strcspn(nomeBusca, "\n")] = '\0';
+    entrada_ler_linha(nomeBusca, TAM_NOME);
+    AssinaturaNome an = assinar_nome(nomeBusca);
 
+    const Item *itens = VC_ITENS(mochila, const Item);
     int encontrado = 0;
-    for (int i = 0; i < qtd; i++) {
-        if (strcmp(mochila[i].nome, nomeBusca) == 0) {
+    for (size_t i = 0; i < mochila->tamanho; i++) {
+        if (nome_igual(itens[i].nome, itens[i].assinatura, nomeBusca, an)) {
             printf("\n🔎 Item encontrado!\n");
             printf("Nome: %s\nTipo: %s\nQuantidade: %d\n",
-                   mochila[i].nome, mochila[i].tipo, mochila[i].quantidade);
+                   itens[i].nome, itens[i].tipo, itens[i].quantidade);
             encontrado = 1;
             break;
         }
@@ -1,7 +1,9 @@
 #include <stdio.h>
 #include <string.h>
+#include "vetor_crescente.h"
+#include "entrada_rapida.h"
+#include "assinatura_nome.h"
 
-#define MAX_ITENS 10
 #define TAM_NOME 30
 #define TAM_TIPO 20
 
@@ -9,81 +11,83 @@ typedef struct {
     char nome[TAM_NOME];
     char tipo[TAM_TIPO];
     int quantidade;
+    AssinaturaNome assinatura; // tamanho + hash do nome, calculados na insercao
 } Item;
 
 void ler_string(char *buffer, int tamanho) {
-    fgets(buffer, tamanho, stdin);
-    buffer[strcspn(buffer, "\n")] = '\0'; // remove \n
+    entrada_ler_linha(buffer, tamanho); // ja sem o \n
 }
 
-void listar_itens(Item mochila[], int qtd) {
-    printf("\n---- Inventario (%d itens) ----\n", qtd);
+void listar_itens(Item mochila[], size_t qtd) {
+    printf("\n---- Inventario (%zu itens) ----\n", qtd);
     if (qtd == 0) { 
         printf("Mochila vazia.\n"); 
         return; 
     }
     printf("%-3s | %-30s | %-20s | %-10s\n", "No", "Nome", "Tipo", "Quantidade");
     printf("----+--------------------------------+----------------------+-----------\n");
-    for (int i = 0; i < qtd; i++) {
-        printf("%-3d | %-30s | %-20s | %-10d\n", i+1, mochila[i].nome, mochila[i].tipo, mochila[i].quantidade);
+    for (size_t i = 0; i < qtd; i++) {
+        printf("%-3zu | %-30s | %-20s | %-10d\n", i+1, mochila[i].nome, mochila[i].tipo, mochila[i].quantidade);
     }
 }
 
 int main() {
-    Item mochila[MAX_ITENS];
-    int qtd = 0;
+    VetorCrescente mochila;
+    vc_init(&mochila, sizeof(Item));
     int opc;
 
     do {
-        printf("\n==== MOCHILA DE SOBREVIVENCIA CODIGO DA ILHA ====\n");1
+        printf("\n==== MOCHILA DE SOBREVIVENCIA CODIGO DA ILHA ====\n");
         printf("1 - Adicionar item\n");
         printf("2 - Remover item pelo nome\n");
         printf("3 - Listar itens\n");
         printf("0 - Sair\n");
         printf("Escolha: ");
-        if (scanf("%d", &opc) != 1) { 
-            while (getchar() != '\n'); 
-            opc = -1; 
-        }
-        getchar(); // remove \n do buffer
+        int r = entrada_ler_int(&opc);
+        if (r != 1) opc = (r == EOF) ? 0 : -1; // fim da entrada encerra
+        entrada_descartar_linha(); // remove o resto da linha
 
         switch(opc) {
-            case 1:
-                if (qtd >= MAX_ITENS) {
-                    printf("Mochila cheia. Remova algum item primeiro.\n");
+            case 1: {
+                Item novo;
+                printf("Nome: "); ler_string(novo.nome, TAM_NOME);
+                novo.assinatura = assinar_nome(novo.nome);
+                printf("Tipo: "); ler_string(novo.tipo, TAM_TIPO);
+                printf("Quantidade: "); entrada_ler_int(&novo.quantidade);
+                entrada_descartar_linha(); // limpar buffer
+                if (!vc_inserir(&mochila, &novo)) {
+                    printf("Memoria insuficiente. Remova algum item primeiro.\n");
                 } else {
-                    printf("Nome: "); ler_string(mochila[qtd].nome, TAM_NOME);
-                    printf("Tipo: "); ler_string(mochila[qtd].tipo, TAM_TIPO);
-                    printf("Quantidade: "); scanf("%d", &mochila[qtd].quantidade);
-                    getchar(); // limpar buffer
-                    qtd++;
                     printf("Item adicionado!\n");
                 }
                 break;
-            case 2:
-                if (qtd == 0) { 
+            }
+            case 2: {
+                if (mochila.tamanho == 0) { 
                     printf("Mochila vazia.\n"); 
                     break; 
                 }
+                Item *itens = VC_ITENS(&mochila, Item);
                 char nome_remover[TAM_NOME];
                 printf("Digite o nome do item a remover: "); 
                 ler_string(nome_remover, TAM_NOME);
-                int idx = -1;
-                for (int i = 0; i < qtd; i++) {
-                    if (strcmp(mochila[i].nome, nome_remover) == 0) {
+                size_t idx = VC_NAO_ENCONTRADO;
+                AssinaturaNome an = assinar_nome(nome_remover);
+                for (size_t i = 0; i < mochila.tamanho; i++) {
+                    if (nome_igual(itens[i].nome, itens[i].assinatura, nome_remover, an)) {
                         idx = i; break;
                     }
                 }
-                if (idx == -1) {
+                if (idx == VC_NAO_ENCONTRADO) {
                     printf("Item nao encontrado.\n");
                 } else {
-                    for (int i = idx; i < qtd - 1; i++) mochila[i] = mochila[i+1];
-                    qtd--;
+                    vc_remover(&mochila, idx);
                     printf("Item removido!\n");
                 }
                 break;
+            }
             case 3:
-                listar_itens(mochila, qtd);
+                listar_itens(VC_ITENS(&mochila, Item), mochila.tamanho);
                 break;
             case 0:
                 printf("Saindo...\n");
@@ -93,5 +97,6 @@ int main() {
         }
     } while (opc != 0);
 
+    vc_liberar(&mochila);
     return 0;
 }
@@ -1,7 +1,9 @@
 #include <stdio.h>
 #include <string.h>
+#include "vetor_crescente.h"
+#include "entrada_rapida.h"
+#include "assinatura_nome.h"
 
-#define MAX_ITENS 10
 #define TAM_NOME 30
 #define TAM_TIPO 20
 
@@ -10,17 +12,17 @@ typedef struct {
     char nome[TAM_NOME];
     char tipo[TAM_TIPO];
     int quantidade;
+    AssinaturaNome assinatura; // tamanho + hash do nome, calculados na insercao
 } Item;
 
 // Função auxiliar para ler strings com segurança
 void ler_string(char *buffer, int tamanho) {
-    fgets(buffer, tamanho, stdin);
-    buffer[strcspn(buffer, "\n")] = '\0'; // remove o '\n'
+    entrada_ler_linha(buffer, tamanho); // ja sem o '\n'
 }
 
 // Lista todos os itens da mochila
-void listar_itens(Item mochila[], int qtd) {
-    printf("\n---- Inventario (%d itens) ----\n", qtd);
+void listar_itens(Item mochila[], size_t qtd) {
+    printf("\n---- Inventario (%zu itens) ----\n", qtd);
     if (qtd == 0) {
         printf("Mochila vazia.\n");
         return;
@@ -28,24 +30,25 @@ void listar_itens(Item mochila[], int qtd) {
 
     printf("%-3s | %-30s | %-20s | %-10s\n", "No", "Nome", "Tipo", "Quantidade");
     printf("----+--------------------------------+----------------------+-----------\n");
-    for (int i = 0; i < qtd; i++) {
-        printf("%-3d | %-30s | %-20s | %-10d\n", i + 1, mochila[i].nome, mochila[i].tipo, mochila[i].quantidade);
+    for (size_t i = 0; i < qtd; i++) {
+        printf("%-3zu | %-30s | %-20s | %-10d\n", i + 1, mochila[i].nome, mochila[i].tipo, mochila[i].quantidade);
     }
 }
 
-// Busca sequencial por nome (retorna índice ou -1 se não achar)
-int buscar_item(Item mochila[], int qtd, char nome_busca[]) {
-    for (int i = 0; i < qtd; i++) {
-        if (strcmp(mochila[i].nome, nome_busca) == 0) {
+// Busca sequencial por nome (retorna índice ou VC_NAO_ENCONTRADO se não achar)
+size_t buscar_item(Item mochila[], size_t qtd, char nome_busca[]) {
+    AssinaturaNome an = assinar_nome(nome_busca);
+    for (size_t i = 0; i < qtd; i++) {
+        if (nome_igual(mochila[i].nome, mochila[i].assinatura, nome_busca, an)) {
             return i; // item encontrado
         }
     }
-    return -1; // não encontrado
+    return VC_NAO_ENCONTRADO; // não encontrado
 }
 
 int main() {
-    Item mochila[MAX_ITENS];
-    int qtd = 0;
+    VetorCrescente mochila;
+    vc_init(&mochila, sizeof(Item));
     int opc;
 
     do {
@@ -56,28 +59,28 @@ int main() {
         printf("4 - Buscar item por nome\n");
         printf("0 - Sair\n");
         printf("Escolha: ");
-        if (scanf("%d", &opc) != 1) {
-            while (getchar() != '\n');
-            opc = -1;
-        }
-        getchar(); // limpar buffer
+        int r = entrada_ler_int(&opc);
+        if (r != 1) opc = (r == EOF) ? 0 : -1; // fim da entrada encerra
+        entrada_descartar_linha(); // limpar buffer
 
         switch (opc) {
-            case 1: // Adicionar
-                if (qtd >= MAX_ITENS) {
-                    printf("Mochila cheia. Remova algum item primeiro.\n");
+            case 1: { // Adicionar
+                Item novo;
+                printf("Nome: "); ler_string(novo.nome, TAM_NOME);
+                novo.assinatura = assinar_nome(novo.nome);
+                printf("Tipo: "); ler_string(novo.tipo, TAM_TIPO);
+                printf("Quantidade: "); entrada_ler_int(&novo.quantidade);
+                entrada_descartar_linha(); // limpar buffer
+                if (!vc_inserir(&mochila, &novo)) {
+                    printf("Memoria insuficiente. Remova algum item primeiro.\n");
                 } else {
-                    printf("Nome: "); ler_string(mochila[qtd].nome, TAM_NOME);
-                    printf("Tipo: "); ler_string(mochila[qtd].tipo, TAM_TIPO);
-                    printf("Quantidade: "); scanf("%d", &mochila[qtd].quantidade);
-                    getchar(); // limpar buffer
-                    qtd++;
                     printf("Item adicionado!\n");
                 }
                 break;
+            }
 
             case 2: { // Remover
-                if (qtd == 0) {
+                if (mochila.tamanho == 0) {
                     printf("Mochila vazia.\n");
                     break;
                 }
@@ -85,24 +88,22 @@ int main() {
                 printf("Digite o nome do item a remover: ");
                 ler_string(nome_remover, TAM_NOME);
 
-                int idx = buscar_item(mochila, qtd, nome_remover);
-                if (idx == -1) {
+                size_t idx = buscar_item(VC_ITENS(&mochila, Item), mochila.tamanho, nome_remover);
+                if (idx == VC_NAO_ENCONTRADO) {
                     printf("Item nao encontrado.\n");
                 } else {
-                    for (int i = idx; i < qtd - 1; i++)
-                        mochila[i] = mochila[i + 1];
-                    qtd--;
+                    vc_remover(&mochila, idx);
                     printf("Item removido!\n");
                 }
                 break;
             }
 
             case 3: // Listar
-                listar_itens(mochila, qtd);
+                listar_itens(VC_ITENS(&mochila, Item), mochila.tamanho);
                 break;
 
             case 4: { // Buscar item
-                if (qtd == 0) {
+                if (mochila.tamanho == 0) {
                     printf("Mochila vazia.\n");
                     break;
                 }
@@ -110,14 +111,15 @@ int main() {
                 printf("Digite o nome do item que deseja buscar: ");
                 ler_string(nome_busca, TAM_NOME);
 
-                int idx = buscar_item(mochila, qtd, nome_busca);
-                if (idx == -1) {
+                Item *itens = VC_ITENS(&mochila, Item);
+                size_t idx = buscar_item(itens, mochila.tamanho, nome_busca);
+                if (idx == VC_NAO_ENCONTRADO) {
                     printf("❌ Item '%s' nao encontrado.\n", nome_busca);
                 } else {
                     printf("\n✅ Item encontrado!\n");
-                    printf("Nome: %s\n", mochila[idx].nome);
-                    printf("Tipo: %s\n", mochila[idx].tipo);
-                    printf("Quantidade: %d\n", mochila[idx].quantidade);
+                    printf("Nome: %s\n", itens[idx].nome);
+                    printf("Tipo: %s\n", itens[idx].tipo);
+                    printf("Quantidade: %d\n", itens[idx].quantidade);
                 }
                 break;
             }
@@ -131,5 +133,6 @@ int main() {
         }
     } while (opc != 0);
 
+    vc_liberar(&mochila);
     return 0;
 }
@@ -1,14 +1,24 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include "vetor_crescente.h"
+#include "entrada_rapida.h"
+#include "selecao_parcial.h"
+#include "arvore_ordem.h"
+#include "tipos_item.h"
+#include "colacao.h"
+#include "assinatura_nome.h"
 
-#define MAX_ITENS 20
 #define TAM_NOME 30
 #define TAM_TIPO 20
 
 typedef struct {
     char nome[TAM_NOME];
     char tipo[TAM_TIPO];
+    uint32_t tipo_id; // tipos_item.h: ordenar por tipo compara tipo_ordem(tipo_id)
+    ChaveColacao chave_nome; // colacao.h: ordenar/buscar por nome compara chaves com memcmp
+    AssinaturaNome assinatura; // assinatura_nome.h: tamanho + hash, rejeita antes do strcmp
     int quantidade;
     int prioridade; // 1 a 5
 } Item;
@@ -21,77 +31,196 @@ typedef enum {
 
 // Função para ler strings com segurança
 void ler_string(char *buffer, int tamanho) {
-    fgets(buffer, tamanho, stdin);
-    buffer[strcspn(buffer, "\n")] = '\0';
+    entrada_ler_linha(buffer, tamanho);
 }
 
 // Listar todos os itens
-void listar_itens(Item mochila[], int qtd) {
-    printf("\n---- Mochila (%d itens) ----\n", qtd);
+void listar_itens(Item mochila[], size_t qtd) {
+    printf("\n---- Mochila (%zu itens) ----\n", qtd);
     if (qtd == 0) {
         printf("Mochila vazia.\n");
         return;
     }
     printf("%-3s | %-30s | %-20s | %-10s | %-8s\n", "No", "Nome", "Tipo", "Quantidade", "Prioridade");
     printf("----+--------------------------------+----------------------+-----------+----------\n");
-    for (int i = 0; i < qtd; i++) {
-        printf("%-3d | %-30s | %-20s | %-10d | %-8d\n", i + 1, mochila[i].nome, mochila[i].tipo, mochila[i].quantidade, mochila[i].prioridade);
+    for (size_t i = 0; i < qtd; i++) {
+        printf("%-3zu | %-30s | %-20s | %-10d | %-8d\n", i + 1, mochila[i].nome, mochila[i].tipo, mochila[i].quantidade, mochila[i].prioridade);
     }
 }
 
 // Busca sequencial por nome
-int busca_sequencial(Item mochila[], int qtd, char nome_busca[]) {
-    for (int i = 0; i < qtd; i++) {
-        if (strcmp(mochila[i].nome, nome_busca) == 0) {
+size_t busca_sequencial(Item mochila[], size_t qtd, char nome_busca[]) {
+    AssinaturaNome an = assinar_nome(nome_busca);
+    for (size_t i = 0; i < qtd; i++) {
+        if (nome_igual(mochila[i].nome, mochila[i].assinatura, nome_busca, an)) {
             return i;
         }
     }
-    return -1;
+    return VC_NAO_ENCONTRADO;
 }
 
 // Insertion Sort com contagem de comparações
-void ordenar_itens(Item mochila[], int qtd, Criterio crit, int *comparacoes) {
+void ordenar_itens(Item mochila[], size_t qtd, Criterio crit, long long *comparacoes) {
     *comparacoes = 0;
-    for (int i = 1; i < qtd; i++) {
+    for (size_t i = 1; i < qtd; i++) {
         Item chave = mochila[i];
-        int j = i - 1;
+        uint32_t ordem_chave = tipo_ordem(chave.tipo_id);
+        size_t j = i; // posicao livre; compara com mochila[j - 1]
         bool cond;
         do {
             if (crit == POR_NOME)
-                cond = strcmp(mochila[j].nome, chave.nome) > 0;
+                cond = colacao_comparar(&mochila[j - 1].chave_nome, mochila[j - 1].nome, &chave.chave_nome, chave.nome) > 0;
             else if (crit == POR_TIPO)
-                cond = strcmp(mochila[j].tipo, chave.tipo) > 0;
+                cond = tipo_ordem(mochila[j - 1].tipo_id) > ordem_chave;
             else // POR_PRIORIDADE
-                cond = mochila[j].prioridade > chave.prioridade;
+                cond = mochila[j - 1].prioridade > chave.prioridade;
 
             (*comparacoes)++;
             if (cond) {
-                mochila[j + 1] = mochila[j];
+                mochila[j] = mochila[j - 1];
                 j--;
             }
-        } while (cond && j >= 0);
-        mochila[j + 1] = chave;
+        } while (cond && j > 0);
+        mochila[j] = chave;
     }
 }
 
-// Busca binária por nome
-int busca_binaria(Item mochila[], int qtd, char nome_busca[], int *comparacoes) {
-    int esquerda = 0, direita = qtd - 1;
+// Comparador para selecao_parcial.h (ctx aponta para o Criterio)
+int comparar_itens(const void *a, const void *b, void *ctx) {
+    const Item *x = a, *y = b;
+    Criterio crit = *(const Criterio *)ctx;
+    if (crit == POR_NOME) return colacao_comparar(&x->chave_nome, x->nome, &y->chave_nome, y->nome);
+    if (crit == POR_TIPO) return (tipo_ordem(x->tipo_id) > tipo_ordem(y->tipo_id)) - (tipo_ordem(x->tipo_id) < tipo_ordem(y->tipo_id));
+    return (x->prioridade > y->prioridade) - (x->prioridade < y->prioridade);
+}
+
+// Ordem total do indice: o criterio, depois os demais campos
+int comparar_itens_total(const void *a, const void *b, void *ctx) {
+    const Item *x = a, *y = b;
+    int c = comparar_itens(a, b, ctx);
+    if (c == 0) c = strcmp(x->nome, y->nome);
+    if (c == 0) c = strcmp(x->tipo, y->tipo);
+    if (c == 0) c = (x->prioridade > y->prioridade) - (x->prioridade < y->prioridade);
+    if (c == 0) c = (x->quantidade > y->quantidade) - (x->quantidade < y->quantidade);
+    return c;
+}
+
+// Indice de posicoes: uma arvore de estatistica de ordem por criterio,
+// atualizada a cada inserir/remover (posicao e K-esimo em O(log n))
+typedef struct {
+    Criterio crit[3];
+    ArvoreOrdem por[3]; // por[c - 1] ordena pelo Criterio c
+} IndicePosicoes;
+
+void posicoes_init(IndicePosicoes *ix) {
+    for (int c = 0; c < 3; c++) {
+        ix->crit[c] = (Criterio)(c + 1);
+        ao_init(&ix->por[c], sizeof(Item), comparar_itens_total, &ix->crit[c]);
+    }
+}
+
+// 0 = sem memoria (nenhuma arvore muda)
+int posicoes_inserir(IndicePosicoes *ix, const Item *it) {
+    for (int c = 0; c < 3; c++) {
+        if (!ao_inserir(&ix->por[c], it)) {
+            while (c-- > 0) ao_remover(&ix->por[c], it);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+void posicoes_remover(IndicePosicoes *ix, const Item *it) {
+    for (int c = 0; c < 3; c++) ao_remover(&ix->por[c], it);
+}
+
+void posicoes_liberar(IndicePosicoes *ix) {
+    for (int c = 0; c < 3; c++) ao_liberar(&ix->por[c]);
+}
+
+// Posicao de um item (por nome) ou item na posicao K, pelo criterio escolhido
+void consultar_posicoes(IndicePosicoes *ix, Item mochila[], size_t qtd) {
+    int criterio = 0, modo = 0;
+    printf("Criterio: 1 - Nome  2 - Tipo  3 - Prioridade: ");
+    entrada_ler_int(&criterio); entrada_descartar_linha();
+    if (criterio < 1 || criterio > 3) { printf("Critério inválido.\n"); return; }
+    printf("1 - Posicao de um item  2 - Item na posicao K: ");
+    entrada_ler_int(&modo); entrada_descartar_linha();
+    ArvoreOrdem *a = &ix->por[criterio - 1];
+    long long antes = a->comparacoes;
+    if (modo == 1) {
+        char nome[TAM_NOME];
+        printf("Nome do item: ");
+        ler_string(nome, TAM_NOME);
+        size_t idx = busca_sequencial(mochila, qtd, nome);
+        if (idx == VC_NAO_ENCONTRADO) { printf("Item '%s' não encontrado.\n", nome); return; }
+        size_t pos = ao_posto(a, &mochila[idx]);
+        printf("'%s' está na posição %zu de %zu. Comparações no índice: %lld\n", nome, pos, ao_tamanho(a), a->comparacoes - antes);
+    } else {
+        size_t k;
+        printf("K (1..%zu): ", ao_tamanho(a));
+        if (entrada_ler_size(&k) != 1) k = 0;
+        entrada_descartar_linha();
+        const Item *it = ao_selecionar(a, k);
+        if (!it) { printf("Posição inválida.\n"); return; }
+        printf("\n%zuº item: %s | Tipo: %s | Quantidade: %d | Prioridade: %d\n", k, it->nome, it->tipo, it->quantidade, it->prioridade);
+    }
+}
+
+// Top N sem mexer na mochila: ordena parcialmente uma copia e lista so os N primeiros
+// (ou mostra apenas o N-esimo, via selecao)
+void mostrar_top(const Item mochila[], size_t qtd) {
+    int criterio = 0, modo = 0;
+    printf("Criterio: 1 - Nome  2 - Tipo  3 - Prioridade: ");
+    entrada_ler_int(&criterio); entrada_descartar_linha();
+    if (criterio < 1 || criterio > 3) { printf("Critério inválido.\n"); return; }
+    printf("1 - Listar os N primeiros  2 - Mostrar so o N-esimo: ");
+    entrada_ler_int(&modo); entrada_descartar_linha();
+    printf("N: ");
+    size_t n_top;
+    if (entrada_ler_size(&n_top) != 1 || n_top == 0) { entrada_descartar_linha(); printf("N inválido.\n"); return; }
+    entrada_descartar_linha();
+    if (n_top > qtd) n_top = qtd;
+    Item *copia = malloc(sizeof(Item) * qtd);
+    if (!copia) { printf("Memoria insuficiente.\n"); return; }
+    memcpy(copia, mochila, sizeof(Item) * qtd);
+    Criterio crit = (Criterio)criterio;
+    long long comparacoes = 0;
+    if (modo == 2) {
+        sp_selecionar(copia, qtd, sizeof(Item), n_top - 1, comparar_itens, &crit, &comparacoes);
+        printf("\n%zuº item: %s | Tipo: %s | Quantidade: %d | Prioridade: %d\nComparações (seleção): %lld\n", n_top,
+            copia[n_top - 1].nome, copia[n_top - 1].tipo, copia[n_top - 1].quantidade, copia[n_top - 1].prioridade, comparacoes);
+    } else {
+        sp_ordenar_parcial(copia, qtd, sizeof(Item), n_top, comparar_itens, &crit, &comparacoes);
+        listar_itens(copia, n_top);
+        printf("Comparações (ordenação parcial dos %zu primeiros de %zu): %lld\n", n_top, qtd, comparacoes);
+    }
+    free(copia);
+}
+
+// Busca binária por nome (na mesma ordem de colacao usada por ordenar_itens)
+size_t busca_binaria(Item mochila[], size_t qtd, char nome_busca[], int *comparacoes) {
+    size_t esquerda = 0, direita = qtd; // intervalo [esquerda, direita)
+    ChaveColacao chave;
+    colacao_chave(&chave, nome_busca);
     *comparacoes = 0;
-    while (esquerda <= direita) {
-        int meio = (esquerda + direita) / 2;
+    while (esquerda < direita) {
+        size_t meio = esquerda + (direita - esquerda) / 2;
         (*comparacoes)++;
-        int cmp = strcmp(mochila[meio].nome, nome_busca);
+        int cmp = colacao_comparar(&mochila[meio].chave_nome, mochila[meio].nome, &chave, nome_busca);
         if (cmp == 0) return meio;
         else if (cmp < 0) esquerda = meio + 1;
-        else direita = meio - 1;
+        else direita = meio;
     }
-    return -1;
+    return VC_NAO_ENCONTRADO;
 }
 
 int main() {
-    Item mochila[MAX_ITENS];
-    int qtd = 0;
+    VetorCrescente v;
+    vc_init(&v, sizeof(Item));
+    IndicePosicoes posicoes; // posicao/K-esimo por criterio, sem ordenar
+    posicoes_init(&posicoes);
+    colacao_iniciar(); // ordem dos nomes pelo LC_COLLATE do ambiente
     int opc;
 
     do {
@@ -102,36 +231,47 @@ int main() {
         printf("4 - Buscar item por nome (Sequencial)\n");
         printf("5 - Ordenar itens\n");
         printf("6 - Buscar item por nome (Binaria, lista deve estar ordenada por nome)\n");
+        printf("7 - Top N / N-esimo por criterio (sem ordenar a mochila)\n");
+        printf("8 - Posicao de um item / item na posicao K (indice por criterio)\n");
         printf("0 - Sair\n");
         printf("Escolha: ");
-        if (scanf("%d", &opc) != 1) { while (getchar() != '\n'); opc = -1; }
-        getchar(); // limpar buffer
+        { int r = entrada_ler_int(&opc); if (r != 1) opc = (r == EOF) ? 0 : -1; }
+        entrada_descartar_linha(); // limpar buffer
+        Item *mochila = VC_ITENS(&v, Item); // revalidado a cada volta (o vetor pode crescer)
+        size_t qtd = v.tamanho;
 
         switch (opc) {
-            case 1:
-                if (qtd >= MAX_ITENS) {
-                    printf("Mochila cheia. Remova algum item primeiro.\n");
+            case 1: {
+                Item novo = {0}; // campos definidos mesmo com entrada invalida (o indice compara todos)
+                printf("Nome: "); ler_string(novo.nome, TAM_NOME);
+                colacao_chave(&novo.chave_nome, novo.nome);
+                novo.assinatura = assinar_nome(novo.nome);
+                printf("Tipo: "); ler_string(novo.tipo, TAM_TIPO);
+                novo.tipo_id = tipo_id(novo.tipo);
+                printf("Quantidade: "); entrada_ler_int(&novo.quantidade);
+                printf("Prioridade (1-5): "); entrada_ler_int(&novo.prioridade);
+                entrada_descartar_linha();
+                if (novo.tipo_id == TIPO_SEM_MEMORIA || !posicoes_inserir(&posicoes, &novo)) {
+                    printf("Memoria insuficiente. Remova algum item primeiro.\n");
+                } else if (!vc_inserir(&v, &novo)) {
+                    posicoes_remover(&posicoes, &novo);
+                    printf("Memoria insuficiente. Remova algum item primeiro.\n");
                 } else {
-                    printf("Nome: "); ler_string(mochila[qtd].nome, TAM_NOME);
-                    printf("Tipo: "); ler_string(mochila[qtd].tipo, TAM_TIPO);
-                    printf("Quantidade: "); scanf("%d", &mochila[qtd].quantidade);
-                    printf("Prioridade (1-5): "); scanf("%d", &mochila[qtd].prioridade);
-                    getchar();
-                    qtd++;
                     printf("Item adicionado!\n");
                 }
                 break;
+            }
 
             case 2: {
                 if (qtd == 0) { printf("Mochila vazia.\n"); break; }
                 char nome_remover[TAM_NOME];
                 printf("Digite o nome do item a remover: ");
                 ler_string(nome_remover, TAM_NOME);
-                int idx = busca_sequencial(mochila, qtd, nome_remover);
-                if (idx == -1) printf("Item não encontrado.\n");
+                size_t idx = busca_sequencial(mochila, qtd, nome_remover);
+                if (idx == VC_NAO_ENCONTRADO) printf("Item não encontrado.\n");
                 else {
-                    for (int i = idx; i < qtd - 1; i++) mochila[i] = mochila[i + 1];
-                    qtd--;
+                    posicoes_remover(&posicoes, &mochila[idx]);
+                    vc_remover(&v, idx);
                     printf("Item removido!\n");
                 }
                 break;
@@ -146,8 +286,8 @@ int main() {
                 char nome_busca[TAM_NOME];
                 printf("Digite o nome do item a buscar: ");
                 ler_string(nome_busca, TAM_NOME);
-                int idx = busca_sequencial(mochila, qtd, nome_busca);
-                if (idx == -1) printf("Item '%s' não encontrado.\n", nome_busca);
+                size_t idx = busca_sequencial(mochila, qtd, nome_busca);
+                if (idx == VC_NAO_ENCONTRADO) printf("Item '%s' não encontrado.\n", nome_busca);
                 else {
                     printf("\nItem encontrado!\nNome: %s\nTipo: %s\nQuantidade: %d\nPrioridade: %d\n",
                         mochila[idx].nome, mochila[idx].tipo, mochila[idx].quantidade, mochila[idx].prioridade);
@@ -159,11 +299,22 @@ int main() {
                 if (qtd == 0) { printf("Mochila vazia.\n"); break; }
                 int criterio;
                 printf("Escolha critério de ordenação:\n1-Nome 2-Tipo 3-Prioridade: ");
-                scanf("%d", &criterio); getchar();
+                entrada_ler_int(&criterio); entrada_descartar_linha();
                 if (criterio < 1 || criterio > 3) { printf("Critério inválido.\n"); break; }
-                int comparacoes;
+                size_t primeiros = 0;
+                printf("Ordenar so os N primeiros? (N, 0 = todos): ");
+                if (entrada_ler_size(&primeiros) != 1) primeiros = 0;
+                entrada_descartar_linha();
+                long long comparacoes = 0;
+                if (primeiros > 0 && primeiros < qtd) {
+                    Criterio crit = (Criterio)criterio;
+                    sp_ordenar_parcial(mochila, qtd, sizeof(Item), primeiros, comparar_itens, &crit, &comparacoes);
+                    printf("%zu primeiros ordenados (parcial)! Comparações realizadas: %lld\n", primeiros, comparacoes);
+                    listar_itens(mochila, primeiros);
+                    break;
+                }
                 ordenar_itens(mochila, qtd, criterio, &comparacoes);
-                printf("Itens ordenados! Comparações realizadas: %d\n", comparacoes);
+                printf("Itens ordenados! Comparações realizadas: %lld\n", comparacoes);
                 listar_itens(mochila, qtd);
                 break;
             }
@@ -173,8 +324,8 @@ int main() {
                 char nome_busca[TAM_NOME];
                 printf("Digite o nome do item para busca binária: ");
                 ler_string(nome_busca, TAM_NOME);
-                int comparacoes, idx = busca_binaria(mochila, qtd, nome_busca, &comparacoes);
-                if (idx == -1) printf("Item '%s' não encontrado.\n", nome_busca);
+                int comparacoes; size_t idx = busca_binaria(mochila, qtd, nome_busca, &comparacoes);
+                if (idx == VC_NAO_ENCONTRADO) printf("Item '%s' não encontrado.\n", nome_busca);
                 else {
                     printf("\nItem encontrado!\nNome: %s\nTipo: %s\nQuantidade: %d\nPrioridade: %d\n",
                         mochila[idx].nome, mochila[idx].tipo, mochila[idx].quantidade, mochila[idx].prioridade);
@@ -183,6 +334,16 @@ int main() {
                 break;
             }
 
+            case 7:
+                if (qtd == 0) { printf("Mochila vazia.\n"); break; }
+                mostrar_top(mochila, qtd);
+                break;
+
+            case 8:
+                if (qtd == 0) { printf("Mochila vazia.\n"); break; }
+                consultar_posicoes(&posicoes, mochila, qtd);
+                break;
+
             case 0:
                 printf("Saindo...\n");
                 break;
@@ -192,5 +353,8 @@ int main() {
         }
     } while (opc != 0);
 
+    posicoes_liberar(&posicoes);
+    tipos_liberar();
+    vc_liberar(&v);
     return 0;
 }
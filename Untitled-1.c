@@ -1,31 +1,80 @@
 /*
  * jogo_inventario_completo.c
  *
- * Integração final: três módulos do desafio
- *  1) Inventário simples (vetor fixo, até 10 itens)
+ * Integração final: quatro módulos do desafio
+ *  1) Inventário simples (vetor crescente, sem limite fixo)
  *  2) Comparativo: Mochila com Vetor dinâmico vs Lista encadeada
  *     - inserção, remoção, listagem, busca sequencial
  *     - ordenação (vetor) + busca binária
+ *     - merge sort bottom-up da lista (nome/tipo/quantidade, sem memoria extra)
+ *     - skip list ordenada por nome (inserir/buscar/remover em O(log n))
+ *     - vetor espelhado em memoria compartilhada (seqlock) para outros processos
+ *     - autosalvamento do vetor numa thread (diario em buffer duplo + rename atomico)
  *     - contadores de comparações e tempos
- *  3) Torre de fuga: gerenciamento de componentes (até 20)
+ *  3) Torre de fuga: gerenciamento de componentes (sem limite fixo)
  *     - ordenações: Bubble (nome), Insertion (tipo), Selection (prioridade)
  *     - busca binária por nome (após ordenação por nome)
+ *     - ordenação adaptativa (insertion/merge natural/counting conforme a entrada)
+ *     - ordenação multi-chave estável com prefixos de 64 bits
+ *     - receitas: conjunto de componentes verificado por ids internos + bitset
+ *     - top N / N-esimo por criterio sem ordenar tudo (selecao_parcial.h)
+ *  4) Servidor de mochilas: uma mochila por id de jogador
+ *     - motor_mochilas.h (shards com trava e arena próprias)
+ *     - benchmark de vazão com várias threads
+ *     - busca global "quais mochilas têm o item" num pool de threads
+ *     - armazenamento frio: mochilas ociosas compactadas, descompactadas no acesso
+ *
+ * Modo servidor (Linux): o motor do módulo 4 num socket Unix com laço epoll
+ *   ./jogo_inventario_completo --servidor [/tmp/mochilas.sock]
+ *   ./jogo_inventario_completo --carga [/tmp/mochilas.sock] [conexoes] [pedidos] [janela]
+ * Modo espectador (POSIX): mostra ao vivo o vetor do modulo 2 (opcao 23 ligada)
+ *   ./jogo_inventario_completo --espectador [/mochila_jogo] [atualizacoes]
  *
  * Compilar:
  * gcc -std=c11 -O2 -Wall -Wextra -o jogo_inventario_completo jogo_inventario_completo.c
  *
  * Observações:
- *  - Entradas textuais usam fgets via ler_linha_trim para segurança.
- *  - Evitei mistura perigosa scanf/fgets ao limpar buffers corretamente.
+ *  - Todos os módulos usam tamanhos size_t e crescem sob demanda
+ *    (vetor_crescente.h); o limite é a memória disponível.
+ *  - Todo o stdin passa por entrada_rapida.h (leitura em blocos, sem scanf):
+ *    ler_linha_trim para textos, entrada_ler_int para numeros.
  *  - Cada módulo tem menu próprio; o menu mestre integra tudo.
  *
  * Autor: Integrado para Abrazon — código direto ao ponto, com humor contido.
  */
 
+#ifdef __linux__
+#define _GNU_SOURCE /* syscall() com -std=c11 */
+#endif
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <stdarg.h>
 #include <time.h>
+#include "vetor_crescente.h"
+#include "entrada_rapida.h"
+#include "epoca_cow.h"
+#include "motor_mochilas.h"
+#include "selecao_parcial.h"
+#include "tipos_item.h"
+#include "memoria_compartilhada.h"
+#include "assinatura_nome.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#define TEM_PTHREAD 1
+#endif
 
 /* ----------------------
    Constantes e utilitários
@@ -35,89 +84,192 @@
 
 /* Safe read line and trim newline */
 void ler_linha_trim(char *buffer, int tamanho) {
-    if (fgets(buffer, tamanho, stdin) == NULL) {
-        buffer[0] = '\0';
-        return;
-    }
-    buffer[strcspn(buffer, "\n")] = '\0';
+    entrada_ler_linha(buffer, tamanho); /* vazio no fim da entrada */
 }
 
-/* Limpa restante do stdin após scanf quando necessário */
+/* Descarta o restante da linha após ler um número */
 void limpar_buffer() {
-    int c;
-    while ((c = getchar()) != '\n' && c != EOF) { }
+    entrada_descartar_linha();
 }
 
 /* Imprime separador */
 void separador() { printf("\n----------------------------------------\n"); }
 
+/* Segundos de relogio de parede (clock() soma a CPU de todas as threads) */
+double agora_s() {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/*
+ * Filtro de Bloom com contadores (aceita remocao):
+ *  - "definitivamente ausente" em BLOOM_K sondagens, sem strcmp
+ *  - "talvez presente" exige a busca normal; quando ela falha, conta
+ *    um falso positivo para a taxa mostrada nos contadores
+ *  - contadores de 8 bits saturam em 255 e deixam de ser decrementados
+ */
+#define BLOOM_K 3
+#define BLOOM_CONTADORES_INICIAL 1024
+#define BLOOM_BITS_POR_ITEM 8
+
+typedef struct {
+    unsigned char *contadores;
+    size_t ncontadores; /* potencia de 2 */
+    size_t elementos;
+    long long consultas;
+    long long negativos;
+    long long falsos_positivos;
+} FiltroBloom;
+
+void bloom_init(FiltroBloom *f, size_t ncontadores) {
+    f->ncontadores = ncontadores;
+    f->contadores = calloc(ncontadores, 1);
+    if (!f->contadores) { fprintf(stderr, "Memoria insuficiente\n"); exit(1); }
+    f->elementos = 0;
+    f->consultas = f->negativos = f->falsos_positivos = 0;
+}
+
+void bloom_liberar(FiltroBloom *f) { free(f->contadores); f->contadores = NULL; f->ncontadores = 0; }
+
+/* Posicao da i-esima sondagem (double hashing) */
+size_t bloom_posicao(const FiltroBloom *f, uint32_t h, int i) {
+    uint32_t h2 = ((h >> 16) | (h << 16)) * 0x9E3779B1u | 1u;
+    return (size_t)(h + (uint32_t)i * h2) & (f->ncontadores - 1);
+}
+
+void bloom_adicionar(FiltroBloom *f, uint32_t h) {
+    for (int i = 0; i < BLOOM_K; ++i) {
+        unsigned char *c = &f->contadores[bloom_posicao(f, h, i)];
+        if (*c < 255) (*c)++;
+    }
+    f->elementos++;
+}
+
+void bloom_remover(FiltroBloom *f, uint32_t h) {
+    for (int i = 0; i < BLOOM_K; ++i) {
+        unsigned char *c = &f->contadores[bloom_posicao(f, h, i)];
+        if (*c > 0 && *c < 255) (*c)--;
+    }
+    if (f->elementos > 0) f->elementos--;
+}
+
+/* 0 = definitivamente ausente; 1 = talvez presente */
+int bloom_talvez_contem(FiltroBloom *f, uint32_t h) {
+    f->consultas++;
+    for (int i = 0; i < BLOOM_K; ++i)
+        if (f->contadores[bloom_posicao(f, h, i)] == 0) { f->negativos++; return 0; }
+    return 1;
+}
+
+/* Chamado quando a busca completa nao achou um "talvez presente" */
+void bloom_registrar_falso_positivo(FiltroBloom *f) { f->falsos_positivos++; }
+
+/* Precisa crescer para manter ~BLOOM_BITS_POR_ITEM contadores por item? */
+int bloom_precisa_crescer(const FiltroBloom *f) {
+    return f->elementos * BLOOM_BITS_POR_ITEM > f->ncontadores;
+}
+
+/* Filtro vazio com o dobro de contadores e as mesmas estatisticas (quem chama reinsere os nomes) */
+void bloom_iniciar_dobro(FiltroBloom *novo, const FiltroBloom *f) {
+    bloom_init(novo, f->ncontadores * 2);
+    novo->consultas = f->consultas;
+    novo->negativos = f->negativos;
+    novo->falsos_positivos = f->falsos_positivos;
+}
+
+/* Taxa observada: falsos positivos / consultas por nomes ausentes */
+double bloom_taxa_fp(const FiltroBloom *f) {
+    long long ausentes = f->negativos + f->falsos_positivos;
+    return ausentes ? (double)f->falsos_positivos / (double)ausentes : 0.0;
+}
+
+void bloom_mostrar(const FiltroBloom *f, const char *rotulo) {
+    printf("Filtro de Bloom (%s): %zu itens, %zu contadores | consultas: %lld | negativos: %lld | falsos positivos: %lld (%.2f%%)\n",
+           rotulo, f->elementos, f->ncontadores, f->consultas, f->negativos, f->falsos_positivos, 100.0 * bloom_taxa_fp(f));
+}
+
 /* ===========================
    MÓDULO 1: Inventário simples
-   (vetor fixo até 10 itens)
+   (vetor crescente)
    =========================== */
-#define MOD1_MAX 10
 
 typedef struct {
     char nome[TAM_NOME];
     char tipo[TAM_TIPO];
     int quantidade;
+    AssinaturaNome assinatura;
 } ItemSimple;
 
-void mod1_inserir(ItemSimple mochila[], int *qtd) {
-    if (*qtd >= MOD1_MAX) {
-        printf("Mochila cheia (max %d). Remova algum item primeiro.\n", MOD1_MAX);
-        return;
-    }
+/* Dobra o filtro da mochila e reinsere os nomes, preservando as estatisticas */
+void mod1_bloom_crescer(FiltroBloom *f, const VetorCrescente *mochila) {
+    const ItemSimple *itens = VC_ITENS(mochila, const ItemSimple);
+    FiltroBloom novo;
+    bloom_iniciar_dobro(&novo, f);
+    for (size_t i = 0; i < mochila->tamanho; ++i) bloom_adicionar(&novo, itens[i].assinatura.hash);
+    bloom_liberar(f);
+    *f = novo;
+}
+
+void mod1_inserir(VetorCrescente *mochila, FiltroBloom *filtro) {
     ItemSimple it;
     printf("Nome: "); ler_linha_trim(it.nome, TAM_NOME);
     printf("Tipo: "); ler_linha_trim(it.tipo, TAM_TIPO);
     printf("Quantidade: ");
-    if (scanf("%d", &it.quantidade) != 1) { limpar_buffer(); printf("Entrada invalida.\n"); return; }
+    if (entrada_ler_int(&it.quantidade) != 1) { limpar_buffer(); printf("Entrada invalida.\n"); return; }
     limpar_buffer();
-    mochila[*qtd] = it;
-    (*qtd)++;
+    it.assinatura = assinar_nome(it.nome);
+    if (!vc_inserir(mochila, &it)) { printf("Memoria insuficiente. Remova algum item primeiro.\n"); return; }
+    bloom_adicionar(filtro, it.assinatura.hash);
+    if (bloom_precisa_crescer(filtro)) mod1_bloom_crescer(filtro, mochila);
     printf("Item adicionado.\n");
 }
 
-void mod1_remover(ItemSimple mochila[], int *qtd) {
-    if (*qtd == 0) { printf("Mochila vazia.\n"); return; }
+void mod1_remover(VetorCrescente *mochila, FiltroBloom *filtro) {
+    if (mochila->tamanho == 0) { printf("Mochila vazia.\n"); return; }
+    ItemSimple *itens = VC_ITENS(mochila, ItemSimple);
     char nome[TAM_NOME];
     printf("Nome do item a remover: "); ler_linha_trim(nome, TAM_NOME);
-    int idx = -1;
-    for (int i = 0; i < *qtd; ++i) if (strcmp(mochila[i].nome, nome) == 0) { idx = i; break; }
-    if (idx == -1) { printf("Item '%s' nao encontrado.\n", nome); return; }
-    for (int j = idx; j < *qtd - 1; ++j) mochila[j] = mochila[j+1];
-    (*qtd)--;
+    size_t idx = VC_NAO_ENCONTRADO;
+    AssinaturaNome an = assinar_nome(nome);
+    if (!bloom_talvez_contem(filtro, an.hash)) { printf("Item '%s' nao encontrado (filtro de Bloom).\n", nome); return; }
+    for (size_t i = 0; i < mochila->tamanho; ++i) if (nome_igual(itens[i].nome, itens[i].assinatura, nome, an)) { idx = i; break; }
+    if (idx == VC_NAO_ENCONTRADO) { bloom_registrar_falso_positivo(filtro); printf("Item '%s' nao encontrado.\n", nome); return; }
+    bloom_remover(filtro, itens[idx].assinatura.hash);
+    vc_remover(mochila, idx);
     printf("Item removido.\n");
 }
 
-void mod1_listar(ItemSimple mochila[], int qtd) {
+void mod1_listar(const VetorCrescente *mochila) {
+    const ItemSimple *itens = VC_ITENS(mochila, const ItemSimple);
     separador();
-    printf("Inventario simples (%d items):\n", qtd);
-    if (qtd == 0) { printf("Vazio.\n"); return; }
-    for (int i = 0; i < qtd; ++i)
-        printf("%d) Nome: %s | Tipo: %s | Quantidade: %d\n",
-               i+1, mochila[i].nome, mochila[i].tipo, mochila[i].quantidade);
+    printf("Inventario simples (%zu items):\n", mochila->tamanho);
+    if (mochila->tamanho == 0) { printf("Vazio.\n"); return; }
+    for (size_t i = 0; i < mochila->tamanho; ++i)
+        printf("%zu) Nome: %s | Tipo: %s | Quantidade: %d\n",
+               i+1, itens[i].nome, itens[i].tipo, itens[i].quantidade);
 }
 
 void modulo1() {
-    ItemSimple mochila[MOD1_MAX];
-    int qtd = 0;
+    VetorCrescente mochila; vc_init(&mochila, sizeof(ItemSimple));
+    FiltroBloom filtro; bloom_init(&filtro, BLOOM_CONTADORES_INICIAL);
     int opc;
     do {
         separador();
-        printf("MÓDULO 1 - Inventario simples (vetor fixo até %d)\n", MOD1_MAX);
+        printf("MÓDULO 1 - Inventario simples (vetor crescente)\n");
         printf("1- Adicionar  2- Remover  3- Listar  0- Voltar\nEscolha: ");
-        if (scanf("%d", &opc) != 1) { limpar_buffer(); opc = -1; }
+        { int r = entrada_ler_int(&opc); if (r != 1) opc = (r == EOF) ? 0 : -1; }
         limpar_buffer();
         switch (opc) {
-            case 1: mod1_inserir(mochila, &qtd); mod1_listar(mochila, qtd); break;
-            case 2: mod1_remover(mochila, &qtd); mod1_listar(mochila, qtd); break;
-            case 3: mod1_listar(mochila, qtd); break;
+            case 1: mod1_inserir(&mochila, &filtro); mod1_listar(&mochila); break;
+            case 2: mod1_remover(&mochila, &filtro); mod1_listar(&mochila); break;
+            case 3: mod1_listar(&mochila); break;
             case 0: break;
             default: printf("Opcao invalida.\n");
         }
     } while (opc != 0);
+    bloom_liberar(&filtro);
+    vc_liberar(&mochila);
 }
 
 /* =========================================
@@ -129,6 +281,7 @@ typedef struct {
     char nome[TAM_NOME];
     char tipo[TAM_TIPO];
     int quantidade;
+    AssinaturaNome assinatura;
 } Item2;
 
 /* LISTA ENC. NODE */
@@ -137,36 +290,224 @@ typedef struct No {
     struct No *proximo;
 } No;
 
+/* Mudancas no vetor registradas para o autosalvamento (replicadas na copia da thread) */
+typedef enum { DIARIO_INSERIR, DIARIO_REMOVER, DIARIO_ORDENAR_NOME } TipoOpDiario;
+
+typedef struct {
+    TipoOpDiario tipo;
+    size_t idx;  /* DIARIO_REMOVER */
+    Item2 item;  /* DIARIO_INSERIR */
+} OpDiario;
+
+typedef struct Autosalvamento Autosalvamento;
+
 /* VETOR DINAMICO */
 typedef struct {
     Item2 *itens;
-    int tamanho;
-    int capacidade;
+    size_t tamanho;
+    size_t capacidade;
+    double fator; /* fator de crescimento (vetor_crescente.h) */
+    /* Contabilidade de memoria (exibida nos contadores) */
+    size_t alocacoes;       /* malloc/realloc do buffer de itens */
+    size_t encolhimentos;   /* realocacoes que devolveram memoria */
+    size_t pico_reservado;  /* maior capacidade em bytes ja reservada */
     int ordenado; /* flag: ordenado por nome? */
+    /* Indice de leitura (layout Eytzinger/BFS), reconstruido sob demanda */
+    char (*eytz_nomes)[TAM_NOME]; /* 1-indexado, eytz_nomes[0] sem uso */
+    size_t *eytz_idx;             /* posicao do nome em itens[] */
+    int eytz_valido;
+    FiltroBloom filtro; /* nomes presentes (rejeita ausentes antes da busca) */
+    /* Versao imutavel para listagens (epoca_cow.h), publicada sob demanda */
+    CanalCow publicado;
+    int publicar_pendente; /* itens[] mudou desde a ultima publicacao */
+    int espelho_pendente;  /* itens[] mudou desde a ultima copia para a memoria compartilhada */
+    Autosalvamento *autosave; /* NULL = sem autosalvamento */
 } VetorDyn;
 
+void vetor_registrar(VetorDyn *v, TipoOpDiario tipo, size_t idx, const Item2 *item);
+
 /* Contadores de comparações (globais do modulo2) */
 long long comp_seq_vetor = 0;
 long long comp_bin_vetor = 0;
 long long comp_seq_lista = 0;
+long long comp_eytz_vetor = 0;
+long long comp_ord_vetor = 0;
+long long comp_ord_lista = 0;
+
+/*
+ * Contadores de hardware (Linux perf_event_open) em volta de cada operacao
+ * medida. Cada evento e aberto separadamente: se o kernel/CPU nao oferecer
+ * algum (VM, perf_event_paranoid alto), so ele aparece como "n/d".
+ */
+enum { HW_CICLOS, HW_INSTRUCOES, HW_L1D_MISS, HW_LLC_MISS, HW_BRANCH_MISS, HW_NEVENTOS };
+enum { MED_VETOR_SEQ, MED_VETOR_BIN, MED_VETOR_EYTZ, MED_VETOR_ORD, MED_LISTA_SEQ, MED_SKIP_BUSCA, MED_LISTA_ORD, MED_NOPS };
+
+typedef struct {
+    long long valor[HW_NEVENTOS];
+    int valido[HW_NEVENTOS];
+    int medido;
+} LeituraHW;
+
+const char *hw_nomes[HW_NEVENTOS] = { "ciclos", "instrucoes", "L1d miss", "LLC miss", "branch miss" };
+const char *med_nomes[MED_NOPS] = { "vetor seq", "vetor bin", "vetor eytz", "vetor ord", "lista seq", "skip busca", "lista ord" };
+
+int hw_fd[HW_NEVENTOS] = { -1, -1, -1, -1, -1 };
+LeituraHW hw_ultimas[MED_NOPS];
+
+#ifdef __linux__
+int hw_abrir_evento(unsigned tipo, unsigned long long config) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof attr);
+    attr.size = sizeof attr;
+    attr.type = tipo;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+#endif
+
+/* Abre os eventos disponiveis; retorna quantos abriram */
+int hw_abrir() {
+    int abertos = 0;
+#ifdef __linux__
+    const unsigned long long cache_leitura_miss =
+        (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    hw_fd[HW_CICLOS] = hw_abrir_evento(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    hw_fd[HW_INSTRUCOES] = hw_abrir_evento(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    hw_fd[HW_L1D_MISS] = hw_abrir_evento(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | cache_leitura_miss);
+    hw_fd[HW_LLC_MISS] = hw_abrir_evento(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    hw_fd[HW_BRANCH_MISS] = hw_abrir_evento(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+    for (int e = 0; e < HW_NEVENTOS; ++e) if (hw_fd[e] >= 0) abertos++;
+#endif
+    memset(hw_ultimas, 0, sizeof hw_ultimas);
+    return abertos;
+}
+
+void hw_fechar() {
+    for (int e = 0; e < HW_NEVENTOS; ++e) {
+#ifdef __linux__
+        if (hw_fd[e] >= 0) close(hw_fd[e]);
+#endif
+        hw_fd[e] = -1;
+    }
+}
+
+void hw_iniciar() {
+#ifdef __linux__
+    for (int e = 0; e < HW_NEVENTOS; ++e)
+        if (hw_fd[e] >= 0) { ioctl(hw_fd[e], PERF_EVENT_IOC_RESET, 0); ioctl(hw_fd[e], PERF_EVENT_IOC_ENABLE, 0); }
+#endif
+}
+
+void hw_parar(int op) {
+    LeituraHW *l = &hw_ultimas[op];
+    l->medido = 1;
+    for (int e = 0; e < HW_NEVENTOS; ++e) {
+        l->valido[e] = 0;
+#ifdef __linux__
+        if (hw_fd[e] >= 0) {
+            ioctl(hw_fd[e], PERF_EVENT_IOC_DISABLE, 0);
+            long long v;
+            if (read(hw_fd[e], &v, sizeof v) == (ssize_t)sizeof v) { l->valor[e] = v; l->valido[e] = 1; }
+        }
+#endif
+    }
+}
+
+void hw_mostrar() {
+    int abertos = 0;
+    for (int e = 0; e < HW_NEVENTOS; ++e) if (hw_fd[e] >= 0) abertos++;
+    if (abertos == 0) { printf("Contadores de hardware indisponiveis (perf_event_open).\n"); return; }
+    printf("%-11s", "Operacao");
+    for (int e = 0; e < HW_NEVENTOS; ++e) printf(" | %12s", hw_nomes[e]);
+    printf("\n");
+    for (int op = 0; op < MED_NOPS; ++op) {
+        if (!hw_ultimas[op].medido) continue;
+        printf("%-11s", med_nomes[op]);
+        for (int e = 0; e < HW_NEVENTOS; ++e) {
+            if (hw_ultimas[op].valido[e]) printf(" | %12lld", hw_ultimas[op].valor[e]);
+            else printf(" | %12s", "n/d");
+        }
+        printf("\n");
+    }
+}
 
 /* Inicializa vetor dinâmico */
 void vetor_init(VetorDyn *v) {
-    v->capacidade = 8;
+    v->capacidade = VC_CAPACIDADE_INICIAL;
+    v->fator = VC_FATOR_CRESCIMENTO;
     v->itens = malloc(sizeof(Item2) * v->capacidade);
     if (!v->itens) { fprintf(stderr, "Memoria insuficiente\n"); exit(1); }
+    v->alocacoes = 1;
+    v->encolhimentos = 0;
+    v->pico_reservado = sizeof(Item2) * v->capacidade;
     v->tamanho = 0;
     v->ordenado = 0;
+    v->eytz_nomes = NULL;
+    v->eytz_idx = NULL;
+    v->eytz_valido = 0;
+    bloom_init(&v->filtro, BLOOM_CONTADORES_INICIAL);
+    cow_init(&v->publicado);
+    v->publicar_pendente = 1;
+    v->espelho_pendente = 1;
+    v->autosave = NULL;
+}
+
+/* Libera vetor e indice */
+void vetor_liberar(VetorDyn *v) {
+    free(v->itens); free(v->eytz_nomes); free(v->eytz_idx);
+    v->itens = NULL; v->eytz_nomes = NULL; v->eytz_idx = NULL;
+    v->tamanho = v->capacidade = 0;
+    v->eytz_valido = 0;
+    bloom_liberar(&v->filtro);
+    cow_liberar(&v->publicado);
+}
+
+/* Dobra o filtro e reinsere os nomes, preservando as estatisticas */
+void vetor_bloom_crescer(VetorDyn *v) {
+    FiltroBloom novo;
+    bloom_iniciar_dobro(&novo, &v->filtro);
+    for (size_t i = 0; i < v->tamanho; ++i) bloom_adicionar(&novo, v->itens[i].assinatura.hash);
+    bloom_liberar(&v->filtro);
+    v->filtro = novo;
+}
+
+/* Garante capacidade (crescimento com checagem de overflow); 0 = sem memoria */
+int vetor_garantir(VetorDyn *v, size_t ncap) {
+    size_t antes = v->capacidade;
+    Item2 *novo = vc_crescer(v->itens, &v->capacidade, ncap, sizeof(Item2), v->fator);
+    if (!novo) return 0;
+    v->itens = novo;
+    if (v->capacidade != antes) {
+        v->alocacoes++;
+        if (v->capacidade * sizeof(Item2) > v->pico_reservado) v->pico_reservado = v->capacidade * sizeof(Item2);
+    }
+    return 1;
+}
+
+/* Devolve capacidade ociosa (histerese; justo = shrink-to-fit). Indice Eytzinger e descartado no justo */
+void vetor_encolher(VetorDyn *v, int justo) {
+    size_t antes = v->capacidade;
+    v->itens = vc_encolher(v->itens, &v->capacidade, v->tamanho, sizeof(Item2), justo);
+    if (v->capacidade != antes) { v->alocacoes++; v->encolhimentos++; }
+    if (justo && !v->eytz_valido) {
+        free(v->eytz_nomes); free(v->eytz_idx);
+        v->eytz_nomes = NULL; v->eytz_idx = NULL;
+    }
 }
 
-/* Garante capacidade */
-void vetor_garantir(VetorDyn *v, int ncap) {
-    if (v->capacidade >= ncap) return;
-    int cap = v->capacidade;
-    while (cap < ncap) cap *= 2;
-    Item2 *novo = realloc(v->itens, sizeof(Item2) * cap);
-    if (!novo) { fprintf(stderr, "Realloc falhou\n"); exit(1); }
-    v->itens = novo; v->capacidade = cap;
+/* Memoria viva x reservada do vetor e estruturas auxiliares */
+void vetor_mostrar_memoria(const VetorDyn *v) {
+    size_t vivos = v->tamanho * sizeof(Item2);
+    size_t reservados = v->capacidade * sizeof(Item2);
+    size_t indice = v->eytz_nomes ? (v->tamanho + 1) * (TAM_NOME + sizeof(size_t)) : 0;
+    printf("Memoria (vetor): vivos %zu B | reservados %zu B | desperdicio %zu B (%.1f%%) | pico %zu B\n",
+           vivos, reservados, reservados - vivos, reservados ? 100.0 * (double)(reservados - vivos) / (double)reservados : 0.0,
+           v->pico_reservado);
+    printf("Memoria (vetor): alocacoes %zu | encolhimentos %zu | capacidade %zu itens | indice %zu B | filtro %zu B\n",
+           v->alocacoes, v->encolhimentos, v->capacidade, indice, v->filtro.ncontadores);
 }
 
 /* Inserir no vetor (append) */
@@ -174,72 +515,467 @@ void vetor_inserir(VetorDyn *v) {
     Item2 it;
     printf("[VETOR] Nome: "); ler_linha_trim(it.nome, TAM_NOME);
     printf("[VETOR] Tipo: "); ler_linha_trim(it.tipo, TAM_TIPO);
-    printf("[VETOR] Quantidade: "); if (scanf("%d", &it.quantidade) != 1) { limpar_buffer(); printf("Entrada invalida.\n"); return; }
+    printf("[VETOR] Quantidade: "); if (entrada_ler_int(&it.quantidade) != 1) { limpar_buffer(); printf("Entrada invalida.\n"); return; }
     limpar_buffer();
-    vetor_garantir(v, v->tamanho + 1);
+    it.assinatura = assinar_nome(it.nome);
+    if (!vetor_garantir(v, v->tamanho + 1)) { printf("[VETOR] Memoria insuficiente.\n"); return; }
     v->itens[v->tamanho++] = it;
+    vetor_registrar(v, DIARIO_INSERIR, 0, &it);
+    v->publicar_pendente = v->espelho_pendente = 1;
     v->ordenado = 0;
-    printf("[VETOR] Item adicionado. Tamanho agora: %d\n", v->tamanho);
+    v->eytz_valido = 0;
+    bloom_adicionar(&v->filtro, it.assinatura.hash);
+    if (bloom_precisa_crescer(&v->filtro)) vetor_bloom_crescer(v);
+    printf("[VETOR] Item adicionado. Tamanho agora: %zu\n", v->tamanho);
 }
 
 /* Remover do vetor por nome (procura sequencial) */
 void vetor_remover(VetorDyn *v) {
     if (v->tamanho == 0) { printf("[VETOR] Vazio.\n"); return; }
     char nome[TAM_NOME]; printf("[VETOR] Nome a remover: "); ler_linha_trim(nome, TAM_NOME);
-    int idx = -1;
+    size_t idx = VC_NAO_ENCONTRADO;
     comp_seq_vetor = 0;
-    for (int i = 0; i < v->tamanho; ++i) {
+    AssinaturaNome an = assinar_nome(nome);
+    if (!bloom_talvez_contem(&v->filtro, an.hash)) { printf("[VETOR] Nao encontrado (filtro de Bloom). Comparacoes: 0\n"); return; }
+    for (size_t i = 0; i < v->tamanho; ++i) {
         comp_seq_vetor++;
-        if (strcmp(v->itens[i].nome, nome) == 0) { idx = i; break; }
+        if (nome_igual(v->itens[i].nome, v->itens[i].assinatura, nome, an)) { idx = i; break; }
     }
-    if (idx == -1) { printf("[VETOR] Nao encontrado. Comparacoes: %lld\n", comp_seq_vetor); return; }
-    for (int j = idx; j < v->tamanho - 1; ++j) v->itens[j] = v->itens[j+1];
+    if (idx == VC_NAO_ENCONTRADO) { bloom_registrar_falso_positivo(&v->filtro); printf("[VETOR] Nao encontrado. Comparacoes: %lld\n", comp_seq_vetor); return; }
+    bloom_remover(&v->filtro, v->itens[idx].assinatura.hash);
+    memmove(&v->itens[idx], &v->itens[idx + 1], sizeof(Item2) * (v->tamanho - idx - 1));
     v->tamanho--;
+    vetor_registrar(v, DIARIO_REMOVER, idx, NULL);
+    v->publicar_pendente = v->espelho_pendente = 1;
+    vetor_encolher(v, 0);
+    v->eytz_valido = 0;
     printf("[VETOR] Removido. Comparacoes: %lld\n", comp_seq_vetor);
 }
 
-/* Listar vetor */
+/* Publica itens[] se mudou desde a ultima versao (copia O(n) so quando alguem vai ler) */
+void vetor_publicar(VetorDyn *v) {
+    if (!v->publicar_pendente) return;
+    if (cow_publicar_marcado(&v->publicado, v->itens, v->tamanho, sizeof(Item2), v->ordenado ? COW_ORDENADA : 0))
+        v->publicar_pendente = 0;
+}
+
+#ifdef MC_DISPONIVEL
+/* Copia itens[] para o segmento compartilhado se mudou (chamado a cada volta do menu) */
+void vetor_espelhar(VetorDyn *v, SegmentoMc *s) {
+    if (!s->cab || !v->espelho_pendente) return;
+    if (mc_publicar(s, v->itens, v->tamanho)) v->espelho_pendente = 0;
+    else printf("[SHM] Sem espaco no segmento; a versao anterior continua visivel.\n");
+}
+
+/* Liga/desliga o espelho do vetor em memoria compartilhada */
+void vetor_alternar_espelho(VetorDyn *v, SegmentoMc *s) {
+    if (s->cab) {
+        mc_remover(s);
+        printf("[SHM] Espelho desligado (espectadores encerram).\n");
+        return;
+    }
+    char nome[MC_TAM_NOME];
+    printf("[SHM] Nome do segmento (Enter = %s): ", MC_NOME_PADRAO); ler_linha_trim(nome, MC_TAM_NOME);
+    if (nome[0] == '\0') strcpy(nome, MC_NOME_PADRAO);
+    if (nome[0] != '/') { printf("[SHM] O nome deve comecar com '/'.\n"); return; }
+    if (!mc_criar(s, nome, sizeof(Item2), v->capacidade)) { printf("[SHM] Nao foi possivel criar o segmento.\n"); return; }
+    v->espelho_pendente = 1;
+    vetor_espelhar(v, s);
+    printf("[SHM] Espelho ligado em %s. Em outro terminal: ./jogo_inventario_completo --espectador %s\n", nome, nome);
+}
+#endif
+
+/*
+ * Caminho de leitura sem trava (RCU): as buscas abaixo so leem uma versao
+ * publicada (imutavel) e so escrevem nos contadores de quem chama, entao
+ * qualquer numero de threads pode chamar enquanto um escritor insere/remove
+ * e publica. As opcoes 4 e 6 do menu usam o mesmo caminho.
+ */
+size_t versao_busca_sequencial(const VersaoCow *f, const char *nome, AssinaturaNome an, long long *comparacoes, long long *strcmps) {
+    const Item2 *it = COW_ITENS(f, Item2);
+    for (size_t i = 0; i < f->tamanho; ++i) {
+        (*comparacoes)++;
+        if (nome_igual_contado(it[i].nome, it[i].assinatura, nome, an, strcmps)) return i;
+    }
+    return VC_NAO_ENCONTRADO;
+}
+
+size_t versao_busca_binaria(const VersaoCow *f, const char *nome, long long *comparacoes) {
+    const Item2 *it = COW_ITENS(f, Item2);
+    size_t l = 0, r = f->tamanho; /* intervalo [l, r) */
+    while (l < r) {
+        size_t mid = l + (r - l) / 2;
+        (*comparacoes)++;
+        int cmp = strcmp(it[mid].nome, nome);
+        if (cmp == 0) return mid;
+        if (cmp < 0) l = mid + 1; else r = mid;
+    }
+    return VC_NAO_ENCONTRADO;
+}
+
+/* Binaria se a versao foi publicada ordenada, senao sequencial; 1 = achou (copia em *saida) */
+int vetor_buscar_sem_trava(CanalCow *c, int leitor, const char *nome, Item2 *saida) {
+    const VersaoCow *f = cow_ler(c, leitor);
+    size_t idx = VC_NAO_ENCONTRADO;
+    long long comparacoes = 0, strcmps = 0; /* locais: nada compartilhado e escrito */
+    if (f) idx = (f->marcas & COW_ORDENADA) ? versao_busca_binaria(f, nome, &comparacoes)
+                                            : versao_busca_sequencial(f, nome, assinar_nome(nome), &comparacoes, &strcmps);
+    if (idx != VC_NAO_ENCONTRADO && saida) *saida = COW_ITENS(f, Item2)[idx];
+    cow_soltar(c, leitor);
+    return idx != VC_NAO_ENCONTRADO;
+}
+
+/* Listar vetor: renderiza uma versao imutavel, nao o vetor vivo */
 void vetor_listar(VetorDyn *v) {
-    separador(); printf("[VETOR] Itens (%d)\n", v->tamanho);
-    if (v->tamanho == 0) { printf("Vazio.\n"); return; }
-    for (int i = 0; i < v->tamanho; ++i)
-        printf("%d) Nome: %s | Tipo: %s | Qt: %d\n",
-               i+1, v->itens[i].nome, v->itens[i].tipo, v->itens[i].quantidade);
+    vetor_publicar(v);
+    int leitor = cow_leitor_entrar(&v->publicado);
+    if (leitor < 0) { printf("[VETOR] Leitores demais no momento.\n"); return; }
+    const VersaoCow *foto = cow_ler(&v->publicado, leitor);
+    size_t n = foto ? foto->tamanho : 0;
+    separador(); printf("[VETOR] Itens (%zu)\n", n);
+    if (n == 0) printf("Vazio.\n");
+    for (size_t i = 0; i < n; ++i) {
+        const Item2 *it = &COW_ITENS(foto, Item2)[i];
+        printf("%zu) Nome: %s | Tipo: %s | Qt: %d\n", i+1, it->nome, it->tipo, it->quantidade);
+    }
+    cow_soltar(&v->publicado, leitor);
+    cow_leitor_sair(&v->publicado, leitor);
 }
 
-/* Selection Sort por nome (simples) para o vetor (usado para demonstracao/ordenar) */
-void vetor_ordenar_nome(VetorDyn *v) {
-    if (v->tamanho < 2) { v->ordenado = 1; printf("[VETOR] Nada a ordenar.\n"); return; }
-    clock_t t0 = clock();
-    for (int i = 0; i < v->tamanho - 1; ++i) {
-        int menor = i;
-        for (int j = i + 1; j < v->tamanho; ++j) {
-            if (strcmp(v->itens[j].nome, v->itens[menor].nome) < 0) menor = j;
+/* Selection Sort por nome; deterministico (o autosalvamento repete na sua copia) */
+long long itens2_ordenar_nome(Item2 itens[], size_t n) {
+    long long comparacoes = 0;
+    for (size_t i = 0; i + 1 < n; ++i) {
+        size_t menor = i;
+        for (size_t j = i + 1; j < n; ++j) {
+            comparacoes++;
+            if (strcmp(itens[j].nome, itens[menor].nome) < 0) menor = j;
         }
         if (menor != i) {
-            Item2 tmp = v->itens[i]; v->itens[i] = v->itens[menor]; v->itens[menor] = tmp;
+            Item2 tmp = itens[i]; itens[i] = itens[menor]; itens[menor] = tmp;
         }
     }
+    return comparacoes;
+}
+
+/* Selection Sort por nome (simples) para o vetor (usado para demonstracao/ordenar) */
+void vetor_ordenar_nome(VetorDyn *v) {
+    if (v->tamanho < 2) { v->ordenado = 1; printf("[VETOR] Nada a ordenar.\n"); return; }
+    clock_t t0 = clock();
+    hw_iniciar();
+    comp_ord_vetor = itens2_ordenar_nome(v->itens, v->tamanho);
+    hw_parar(MED_VETOR_ORD);
     clock_t t1 = clock();
+    vetor_registrar(v, DIARIO_ORDENAR_NOME, 0, NULL);
+    v->publicar_pendente = v->espelho_pendente = 1;
     v->ordenado = 1;
+    v->eytz_valido = 0;
     double ms = (double)(t1 - t0) * 1000.0 / CLOCKS_PER_SEC;
-    printf("[VETOR] Ordenado por nome (Selection). Tempo: %.3f ms\n", ms);
+    printf("[VETOR] Ordenado por nome (Selection). Comparacoes: %lld | Tempo: %.3f ms\n", comp_ord_vetor, ms);
+}
+
+/*
+ * Autosalvamento do vetor em segundo plano
+ *  - o menu nunca serializa nem espera o disco: cada mudanca vira uma
+ *    operacao num diario (inserir item, remover posicao, ordenar por nome)
+ *  - buffer duplo de diarios: o menu acrescenta no ativo; a cada intervalo a
+ *    thread troca os dois sob a trava (O(1), qualquer tamanho de inventario),
+ *    reaplica as operacoes na sua propria copia do vetor e grava a copia
+ *  - a thread roda como SCHED_IDLE (so usa CPU que o menu nao quer) e o menu
+ *    nunca espera por ela: registra com trylock e, se a trava estiver com a
+ *    thread, guarda a operacao numa fila propria e entrega no proximo registro
+ *  - gravacao em <arquivo>.tmp + fsync + rename: o arquivo salvo e sempre
+ *    uma versao inteira, mesmo se o jogo cair no meio
+ */
+#ifdef TEM_PTHREAD
+#define AUTOSAVE_INTERVALO_MS 2000
+#define AUTOSAVE_ARQUIVO "mochila_vetor.sav"
+#define AUTOSAVE_MAGICO "MOCHSAV1" /* + uint64 n + n * (nome, tipo, int32 quantidade) */
+#define AUTOSAVE_BENCH_ITENS 1000000
+#define AUTOSAVE_BENCH_OPS_DURANTE 20000
+
+struct Autosalvamento {
+    pthread_t thread;
+    pthread_mutex_t trava;
+    pthread_cond_t sinal;
+    VetorCrescente diario[2];  /* OpDiario; o menu so escreve em diario[ativo] */
+    int ativo;
+    int encerrar, dessincronizado;
+    size_t pedidos, atendidos; /* geracoes de "salvar agora": pedidos != atendidos = acordar ja */
+    unsigned intervalo_ms;
+    /* So do menu: operacoes que ainda nao entraram no diario (trava ocupada) */
+    VetorCrescente fila_menu;
+    int fila_sem_memoria;
+    char arquivo[256];
+    /* So da thread: o vetor reconstruido pelo diario */
+    VetorCrescente copia;
+    /* Estatisticas da thread (lidas sob a trava) */
+    size_t salvamentos, falhas, ops_aplicadas;
+    unsigned long long bytes_gravados;
+    double ultimo_salvamento_ms, inicio_s;
+    /* Estatisticas do menu: tempo parado em registrar (trylock + copias) */
+    size_t registros;
+    double bloqueio_total_ms, bloqueio_max_ms;
+};
+
+/* Grava a copia em arquivo.tmp e troca pelo arquivo final; devolve bytes (0 = falhou) */
+size_t autosave_gravar(const Autosalvamento *a) {
+    char tmp[sizeof a->arquivo + 4];
+    snprintf(tmp, sizeof tmp, "%s.tmp", a->arquivo);
+    FILE *f = fopen(tmp, "wb");
+    if (!f) return 0;
+    const Item2 *it = VC_ITENS(&a->copia, const Item2);
+    uint64_t n = a->copia.tamanho;
+    int ok = fwrite(AUTOSAVE_MAGICO, 1, 8, f) == 8 && fwrite(&n, sizeof n, 1, f) == 1;
+    for (size_t i = 0; ok && i < a->copia.tamanho; ++i) {
+        char nome[TAM_NOME] = {0}, tipo[TAM_TIPO] = {0}; /* o arquivo nao leva lixo apos o '\0' */
+        memcpy(nome, it[i].nome, strnlen(it[i].nome, TAM_NOME - 1));
+        memcpy(tipo, it[i].tipo, strnlen(it[i].tipo, TAM_TIPO - 1));
+        int32_t q = it[i].quantidade;
+        ok = fwrite(nome, TAM_NOME, 1, f) == 1 && fwrite(tipo, TAM_TIPO, 1, f) == 1 && fwrite(&q, sizeof q, 1, f) == 1;
+    }
+    ok = ok && fflush(f) == 0 && fsync(fileno(f)) == 0;
+    ok = fclose(f) == 0 && ok;
+    if (!ok || rename(tmp, a->arquivo) != 0) { remove(tmp); return 0; }
+    return 8 + sizeof n + a->copia.tamanho * (TAM_NOME + TAM_TIPO + sizeof(int32_t));
+}
+
+/* Reaplica um diario na copia; 0 = sem memoria (a copia deixa de ser confiavel) */
+int autosave_aplicar(Autosalvamento *a, const VetorCrescente *diario) {
+    const OpDiario *op = VC_ITENS(diario, const OpDiario);
+    for (size_t i = 0; i < diario->tamanho; ++i) {
+        if (op[i].tipo == DIARIO_INSERIR) {
+            if (!vc_inserir(&a->copia, &op[i].item)) return 0;
+        } else if (op[i].tipo == DIARIO_REMOVER) {
+            Item2 *c = VC_ITENS(&a->copia, Item2);
+            size_t n = a->copia.tamanho;
+            if (op[i].idx < n) { memmove(&c[op[i].idx], &c[op[i].idx + 1], sizeof(Item2) * (n - op[i].idx - 1)); a->copia.tamanho--; }
+        } else {
+            itens2_ordenar_nome(VC_ITENS(&a->copia, Item2), a->copia.tamanho);
+        }
+    }
+    return 1;
+}
+
+void *autosave_thread(void *arg) {
+    Autosalvamento *a = arg;
+    int primeiro = 1;
+#ifdef __linux__
+    /* So usa CPU ociosa: acordar a thread nunca tira a vez do menu (importa com um nucleo so) */
+    struct sched_param sp = { 0 };
+    pthread_setschedparam(pthread_self(), SCHED_IDLE, &sp);
+#endif
+    pthread_mutex_lock(&a->trava);
+    for (;;) {
+        struct timespec prazo;
+        clock_gettime(CLOCK_REALTIME, &prazo);
+        prazo.tv_sec += a->intervalo_ms / 1000;
+        prazo.tv_nsec += (long)(a->intervalo_ms % 1000) * 1000000L;
+        if (prazo.tv_nsec >= 1000000000L) { prazo.tv_sec++; prazo.tv_nsec -= 1000000000L; }
+        while (!a->encerrar && a->pedidos == a->atendidos)
+            if (pthread_cond_timedwait(&a->sinal, &a->trava, &prazo) != 0) break; /* intervalo venceu */
+        int sair = a->encerrar, dessincronizado = a->dessincronizado;
+        size_t pedido = a->pedidos; /* atendido no fim desta volta, mesmo sem nada para gravar */
+        VetorCrescente *pronto = &a->diario[a->ativo];
+        a->ativo ^= 1; /* o menu continua no outro diario (ja vazio) */
+        pthread_mutex_unlock(&a->trava);
+
+        size_t ops = pronto->tamanho;
+        int ok = !dessincronizado && autosave_aplicar(a, pronto);
+        pronto->tamanho = 0; /* mantem a capacidade para a proxima troca */
+        size_t bytes = 0;
+        double t0 = agora_s(), ms = 0;
+        if (ok && (ops || primeiro)) { bytes = autosave_gravar(a); ms = (agora_s() - t0) * 1000.0; }
+
+        pthread_mutex_lock(&a->trava);
+        if (!ok) a->dessincronizado = 1;
+        a->ops_aplicadas += ops;
+        if (ok && (ops || primeiro)) {
+            if (bytes) { a->salvamentos++; a->bytes_gravados += bytes; a->ultimo_salvamento_ms = ms; primeiro = 0; }
+            else a->falhas++;
+        }
+        a->atendidos = pedido;
+        pthread_cond_broadcast(&a->sinal); /* acorda quem espera um salvamento (benchmark/saida) */
+        if (sair) break;
+    }
+    pthread_mutex_unlock(&a->trava);
+    return NULL;
+}
+
+/* Copia inicial vazia (o vetor do modulo 2 comeca vazio); 0 = thread nao iniciou */
+int autosave_iniciar(Autosalvamento *a, const char *arquivo, unsigned intervalo_ms) {
+    memset(a, 0, sizeof *a);
+    snprintf(a->arquivo, sizeof a->arquivo, "%s", arquivo);
+    a->intervalo_ms = intervalo_ms ? intervalo_ms : 1;
+    a->inicio_s = agora_s();
+    vc_init(&a->diario[0], sizeof(OpDiario));
+    vc_init(&a->diario[1], sizeof(OpDiario));
+    vc_init(&a->copia, sizeof(Item2));
+    vc_init(&a->fila_menu, sizeof(OpDiario));
+    pthread_mutex_init(&a->trava, NULL);
+    pthread_cond_init(&a->sinal, NULL);
+    if (pthread_create(&a->thread, NULL, autosave_thread, a) != 0) {
+        pthread_mutex_destroy(&a->trava);
+        pthread_cond_destroy(&a->sinal);
+        return 0;
+    }
+    return 1;
 }
 
-/* Busca sequencial no vetor (mede comparacoes e tempo) */
+/* Passa a fila do menu para o diario ativo, na ordem (quem chama esta com a trava) */
+void autosave_entregar(Autosalvamento *a) {
+    VetorCrescente *d = &a->diario[a->ativo];
+    size_t n = a->fila_menu.tamanho;
+    if (a->fila_sem_memoria || (n && !vc_garantir(d, d->tamanho + n))) a->dessincronizado = 1;
+    else if (n) {
+        memcpy(VC_ITENS(d, OpDiario) + d->tamanho, a->fila_menu.dados, n * sizeof(OpDiario));
+        d->tamanho += n;
+    }
+    a->fila_menu.tamanho = 0;
+}
+
+/* Chamado pelo menu a cada mudanca: enfileira e entrega se a trava estiver livre */
+void autosave_registrar(Autosalvamento *a, TipoOpDiario tipo, size_t idx, const Item2 *item) {
+    double t0 = agora_s();
+    OpDiario op;
+    op.tipo = tipo;
+    op.idx = idx;
+    if (item) op.item = *item;
+    else memset(&op.item, 0, sizeof op.item);
+    if (!vc_inserir(&a->fila_menu, &op)) a->fila_sem_memoria = 1;
+    /* trava com a thread (troca ou estatisticas): a operacao espera na fila */
+    if (pthread_mutex_trylock(&a->trava) == 0) {
+        autosave_entregar(a);
+        pthread_mutex_unlock(&a->trava);
+    }
+    double ms = (agora_s() - t0) * 1000.0;
+    a->registros++;
+    a->bloqueio_total_ms += ms;
+    if (ms > a->bloqueio_max_ms) a->bloqueio_max_ms = ms;
+}
+
+/* Acorda a thread para salvar ja; devolve a geracao do pedido (para autosave_esperar) */
+size_t autosave_pedir(Autosalvamento *a) {
+    pthread_mutex_lock(&a->trava);
+    autosave_entregar(a);
+    size_t pedido = ++a->pedidos;
+    pthread_cond_broadcast(&a->sinal);
+    pthread_mutex_unlock(&a->trava);
+    return pedido;
+}
+
+/*
+ * Bloqueia ate a thread atender o pedido (o menu dorme: a thread ociosa roda).
+ * Sem mudancas desde o ultimo salvamento o pedido e atendido sem gravar.
+ */
+void autosave_esperar(Autosalvamento *a, size_t pedido) {
+    pthread_mutex_lock(&a->trava);
+    while (a->atendidos < pedido) pthread_cond_wait(&a->sinal, &a->trava);
+    pthread_mutex_unlock(&a->trava);
+}
+
+void autosave_salvar_e_esperar(Autosalvamento *a) { autosave_esperar(a, autosave_pedir(a)); }
+
+/* Ultimo salvamento com o que estiver no diario, depois encerra a thread */
+void autosave_encerrar(Autosalvamento *a) {
+    pthread_mutex_lock(&a->trava);
+    autosave_entregar(a);
+    a->encerrar = 1;
+    pthread_cond_broadcast(&a->sinal);
+    pthread_mutex_unlock(&a->trava);
+    pthread_join(a->thread, NULL);
+    pthread_mutex_destroy(&a->trava);
+    pthread_cond_destroy(&a->sinal);
+    vc_liberar(&a->diario[0]);
+    vc_liberar(&a->diario[1]);
+    vc_liberar(&a->copia);
+    vc_liberar(&a->fila_menu);
+}
+
+void autosave_mostrar(Autosalvamento *a) {
+    pthread_mutex_lock(&a->trava);
+    double decorrido = agora_s() - a->inicio_s;
+    printf("[AUTOSAVE] Arquivo: %s | intervalo %u ms | salvamentos %zu (falhas %zu, %.2f por minuto) | %llu B gravados\n",
+           a->arquivo, a->intervalo_ms, a->salvamentos, a->falhas,
+           decorrido > 0 ? 60.0 * (double)a->salvamentos / decorrido : 0.0, a->bytes_gravados);
+    printf("[AUTOSAVE] Ultimo salvamento (na thread): %.3f ms | operacoes reaplicadas: %zu | pendentes: %zu%s\n",
+           a->ultimo_salvamento_ms, a->ops_aplicadas, a->diario[a->ativo].tamanho + a->fila_menu.tamanho,
+           a->dessincronizado ? " | DESATIVADO (sem memoria para o diario)" : "");
+    pthread_mutex_unlock(&a->trava);
+    printf("[AUTOSAVE] Menu parado por causa do autosave: %.3f ms no total, maximo %.4f ms em %zu registros\n",
+           a->bloqueio_total_ms, a->bloqueio_max_ms, a->registros);
+}
+
+/*
+ * 10^6 itens: o menu registra as insercoes, pede um salvamento e continua
+ * mudando o vetor sem esperar a gravacao. Mede quanto o pedido e cada
+ * mudanca seguinte pararam o menu.
+ */
+void autosave_benchmark() {
+    const char *arquivo = "mochila_bench.sav";
+    Autosalvamento a;
+    if (!autosave_iniciar(&a, arquivo, 60000)) { printf("[AUTOSAVE] Thread nao iniciou.\n"); return; }
+    autosave_salvar_e_esperar(&a); /* primeiro salvamento (vazio) fora da medida */
+    Item2 it;
+    memset(&it, 0, sizeof it);
+    strcpy(it.tipo, "carga");
+    for (size_t i = 0; i < AUTOSAVE_BENCH_ITENS; ++i) {
+        snprintf(it.nome, TAM_NOME, "Item %zu", i);
+        it.quantidade = (int)(i % 100);
+        autosave_registrar(&a, DIARIO_INSERIR, 0, &it);
+    }
+    double max_carga = a.bloqueio_max_ms;
+    a.bloqueio_max_ms = 0;
+    size_t registros_antes = a.registros;
+    double t0 = agora_s();
+    size_t pedido = autosave_pedir(&a);
+    double pedido_ms = (agora_s() - t0) * 1000.0;
+    for (int k = 0; k < AUTOSAVE_BENCH_OPS_DURANTE; ++k)
+        autosave_registrar(&a, k % 2 ? DIARIO_REMOVER : DIARIO_INSERIR, AUTOSAVE_BENCH_ITENS, &it); /* insere e tira do fim */
+    double menu_ms = (agora_s() - t0) * 1000.0;
+    autosave_esperar(&a, pedido);
+    double total_ms = (agora_s() - t0) * 1000.0;
+    printf("[AUTOSAVE] %d itens registrados (maior parada por registro: %.4f ms)\n", AUTOSAVE_BENCH_ITENS, max_carga);
+    printf("[AUTOSAVE] Pedido de salvamento: %.4f ms no menu (meta < 1 ms: %s) | depois, %zu mudancas em %.3f ms, maior parada %.4f ms\n",
+           pedido_ms, pedido_ms < 1.0 ? "ok" : "NAO", a.registros - registros_antes, menu_ms - pedido_ms, a.bloqueio_max_ms);
+    printf("[AUTOSAVE] Salvamento pronto %.3f ms apos o pedido (o menu so esperou porque o benchmark pediu)\n", total_ms);
+    autosave_mostrar(&a);
+    autosave_encerrar(&a);
+    remove(arquivo);
+}
+#endif /* TEM_PTHREAD */
+
+void vetor_registrar(VetorDyn *v, TipoOpDiario tipo, size_t idx, const Item2 *item) {
+#ifdef TEM_PTHREAD
+    if (v->autosave) autosave_registrar(v->autosave, tipo, idx, item);
+#else
+    (void)v; (void)tipo; (void)idx; (void)item;
+#endif
+}
+
+/* Busca sequencial na versao publicada do vetor (mede comparacoes e tempo) */
 void vetor_busca_sequencial(VetorDyn *v) {
     if (v->tamanho == 0) { printf("[VETOR] Vazio.\n"); return; }
     char nome[TAM_NOME]; printf("[VETOR] Nome pra buscar (sequencial): "); ler_linha_trim(nome, TAM_NOME);
+    vetor_publicar(v);
+    int leitor = cow_leitor_entrar(&v->publicado);
+    if (leitor < 0) { printf("[VETOR] Leitores demais no momento.\n"); return; }
+    const VersaoCow *f = cow_ler(&v->publicado, leitor);
     comp_seq_vetor = 0;
     clock_t t0 = clock();
-    int idx = -1;
-    for (int i = 0; i < v->tamanho; ++i) {
-        comp_seq_vetor++;
-        if (strcmp(v->itens[i].nome, nome) == 0) { idx = i; break; }
-    }
+    size_t idx = VC_NAO_ENCONTRADO;
+    hw_iniciar();
+    if (f) idx = versao_busca_sequencial(f, nome, assinar_nome(nome), &comp_seq_vetor, &strcmp_igualdade);
+    hw_parar(MED_VETOR_SEQ);
     clock_t t1 = clock(); double ms = (double)(t1 - t0) * 1000.0 / CLOCKS_PER_SEC;
-    if (idx == -1) printf("[VETOR] Nao encontrado. Comparacoes: %lld | Tempo: %.3f ms\n", comp_seq_vetor, ms);
-    else { printf("[VETOR] Encontrado idx %d. Comparacoes: %lld | Tempo: %.3f ms\n", idx, comp_seq_vetor, ms); printf("Detalhe: Nome:%s Tipo:%s Qt:%d\n", v->itens[idx].nome, v->itens[idx].tipo, v->itens[idx].quantidade); }
+    if (idx == VC_NAO_ENCONTRADO) printf("[VETOR] Nao encontrado. Comparacoes: %lld | Tempo: %.3f ms\n", comp_seq_vetor, ms);
+    else {
+        const Item2 *it = &COW_ITENS(f, Item2)[idx];
+        printf("[VETOR] Encontrado idx %zu. Comparacoes: %lld | Tempo: %.3f ms\n", idx, comp_seq_vetor, ms);
+        printf("Detalhe: Nome:%s Tipo:%s Qt:%d\n", it->nome, it->tipo, it->quantidade);
+    }
+    cow_soltar(&v->publicado, leitor);
+    cow_leitor_sair(&v->publicado, leitor);
 }
 
 /* Busca binaria no vetor (apos ordenacao por nome) */
@@ -252,44 +988,136 @@ void vetor_busca_binaria(VetorDyn *v) {
         else { printf("[VETOR] Abortando busca binaria.\n"); return; }
     }
     char nome[TAM_NOME]; printf("[VETOR] Nome pra buscar (binaria): "); ler_linha_trim(nome, TAM_NOME);
+    vetor_publicar(v); /* ordenado: a versao sai com COW_ORDENADA */
+    int leitor = cow_leitor_entrar(&v->publicado);
+    if (leitor < 0) { printf("[VETOR] Leitores demais no momento.\n"); return; }
+    const VersaoCow *f = cow_ler(&v->publicado, leitor);
     comp_bin_vetor = 0;
-    int l = 0, r = v->tamanho - 1, idx = -1;
+    size_t idx = VC_NAO_ENCONTRADO;
     clock_t t0 = clock();
-    while (l <= r) {
-        int mid = l + (r - l) / 2;
-        comp_bin_vetor++;
-        int cmp = strcmp(v->itens[mid].nome, nome);
-        if (cmp == 0) { idx = mid; break; }
-        else if (cmp < 0) l = mid + 1;
-        else r = mid - 1;
+    hw_iniciar();
+    if (f && (f->marcas & COW_ORDENADA)) idx = versao_busca_binaria(f, nome, &comp_bin_vetor);
+    hw_parar(MED_VETOR_BIN);
+    clock_t t1 = clock(); double ms = (double)(t1 - t0) * 1000.0 / CLOCKS_PER_SEC;
+    cow_soltar(&v->publicado, leitor);
+    cow_leitor_sair(&v->publicado, leitor);
+    if (f && !(f->marcas & COW_ORDENADA)) printf("[VETOR] Versao publicada fora de ordem; ordene e tente de novo.\n");
+    else if (idx == VC_NAO_ENCONTRADO) printf("[VETOR] Nao encontrado. Comparacoes: %lld | Tempo: %.3f ms\n", comp_bin_vetor, ms);
+    else printf("[VETOR] Encontrado idx %zu. Comparacoes: %lld | Tempo: %.3f ms\n", idx, comp_bin_vetor, ms);
+}
+
+/*
+ * Indice Eytzinger: os nomes ordenados sao copiados em ordem de busca em
+ * largura (filhos de k em 2k e 2k+1). Os primeiros niveis ficam juntos no
+ * cache e os netos de cada no sao pre-carregados antes da comparacao.
+ * Cerca de log2(n)+1 comparacoes; a forma da arvore nao e a da recursao
+ * pelo meio, entao a contagem pode diferir da busca binaria classica.
+ * As funcoes eytz_* servem ao vetor do modulo 2 e aos componentes do
+ * modulo 3: o nome do elemento i fica em origem + i * passo.
+ */
+size_t eytz_preencher(char (*nomes)[TAM_NOME], size_t *idx, size_t n, const char *origem, size_t passo, size_t i, size_t k) {
+    if (k <= n) {
+        i = eytz_preencher(nomes, idx, n, origem, passo, i, 2 * k);
+        memcpy(nomes[k], origem + i * passo, TAM_NOME);
+        idx[k] = i++;
+        i = eytz_preencher(nomes, idx, n, origem, passo, i, 2 * k + 1);
+    }
+    return i;
+}
+
+/* Retorna a posicao no vetor de origem ou VC_NAO_ENCONTRADO */
+size_t eytz_buscar(char (*nomes)[TAM_NOME], const size_t *idx, size_t n, const char *nome, long long *comparacoes) {
+    size_t k = 1;
+    while (k <= n) {
+        if (4 * k <= n) {
+            __builtin_prefetch(nomes[4 * k]);
+            __builtin_prefetch(nomes[4 * k + 3 <= n ? 4 * k + 3 : n]);
+        }
+        (*comparacoes)++;
+        int cmp = strcmp(nomes[k], nome);
+        if (cmp == 0) return idx[k];
+        k = 2 * k + (cmp < 0);
+    }
+    return VC_NAO_ENCONTRADO;
+}
+
+void vetor_eytz_construir(VetorDyn *v) {
+    free(v->eytz_nomes); free(v->eytz_idx);
+    v->eytz_nomes = malloc(sizeof(*v->eytz_nomes) * (v->tamanho + 1));
+    v->eytz_idx = malloc(sizeof(size_t) * (v->tamanho + 1));
+    if (!v->eytz_nomes || !v->eytz_idx) { fprintf(stderr, "Memoria insuficiente\n"); exit(1); }
+    eytz_preencher(v->eytz_nomes, v->eytz_idx, v->tamanho, v->itens[0].nome, sizeof(Item2), 0, 1);
+    v->eytz_valido = 1;
+}
+
+/* Retorna posicao em itens[] ou VC_NAO_ENCONTRADO */
+size_t vetor_eytz_buscar(VetorDyn *v, const char *nome, long long *comparacoes) {
+    return eytz_buscar(v->eytz_nomes, v->eytz_idx, v->tamanho, nome, comparacoes);
+}
+
+/* Busca pelo indice Eytzinger (reconstroi se houve mutacao) */
+void vetor_busca_eytzinger(VetorDyn *v) {
+    if (v->tamanho == 0) { printf("[VETOR] Vazio.\n"); return; }
+    if (!v->ordenado) {
+        printf("[VETOR] Vetor nao ordenado. Deseja ordenar agora? (s/n): ");
+        char r[4]; ler_linha_trim(r, 4);
+        if (r[0] == 's' || r[0] == 'S') vetor_ordenar_nome(v);
+        else { printf("[VETOR] Abortando busca pelo indice.\n"); return; }
     }
+    if (!v->eytz_valido) {
+        clock_t t0 = clock();
+        vetor_eytz_construir(v);
+        clock_t t1 = clock(); double ms = (double)(t1 - t0) * 1000.0 / CLOCKS_PER_SEC;
+        printf("[VETOR] Indice Eytzinger reconstruido (%zu nomes). Tempo: %.3f ms\n", v->tamanho, ms);
+    }
+    char nome[TAM_NOME]; printf("[VETOR] Nome pra buscar (indice): "); ler_linha_trim(nome, TAM_NOME);
+    comp_eytz_vetor = 0;
+    clock_t t0 = clock();
+    hw_iniciar();
+    size_t idx = vetor_eytz_buscar(v, nome, &comp_eytz_vetor);
+    hw_parar(MED_VETOR_EYTZ);
     clock_t t1 = clock(); double ms = (double)(t1 - t0) * 1000.0 / CLOCKS_PER_SEC;
-    if (idx == -1) printf("[VETOR] Nao encontrado. Comparacoes: %lld | Tempo: %.3f ms\n", comp_bin_vetor, ms);
-    else printf("[VETOR] Encontrado idx %d. Comparacoes: %lld | Tempo: %.3f ms\n", idx, comp_bin_vetor, ms);
+    if (idx == VC_NAO_ENCONTRADO) printf("[VETOR] Nao encontrado. Comparacoes: %lld | Tempo: %.3f ms\n", comp_eytz_vetor, ms);
+    else printf("[VETOR] Encontrado idx %zu. Comparacoes: %lld | Tempo: %.3f ms\n", idx, comp_eytz_vetor, ms);
+}
+
+/* Dobra o filtro da lista e reinsere os nomes, preservando as estatisticas */
+void lista_bloom_crescer(FiltroBloom *f, const No *head) {
+    FiltroBloom novo;
+    bloom_iniciar_dobro(&novo, f);
+    for (const No *p = head; p; p = p->proximo) bloom_adicionar(&novo, p->dados.assinatura.hash);
+    bloom_liberar(f);
+    *f = novo;
 }
 
 /* LISTA: inserir no inicio */
-void lista_inserir(No **head) {
+void lista_inserir(No **head, FiltroBloom *filtro) {
     Item2 it;
     printf("[LISTA] Nome: "); ler_linha_trim(it.nome, TAM_NOME);
     printf("[LISTA] Tipo: "); ler_linha_trim(it.tipo, TAM_TIPO);
-    printf("[LISTA] Quantidade: "); if (scanf("%d", &it.quantidade) != 1) { limpar_buffer(); printf("Entrada invalida.\n"); return; }
+    printf("[LISTA] Quantidade: "); if (entrada_ler_int(&it.quantidade) != 1) { limpar_buffer(); printf("Entrada invalida.\n"); return; }
     limpar_buffer();
+    it.assinatura = assinar_nome(it.nome);
     No *n = malloc(sizeof(No));
     if (!n) { fprintf(stderr, "Memoria insuficiente\n"); exit(1); }
     n->dados = it; n->proximo = *head; *head = n;
+    bloom_adicionar(filtro, it.assinatura.hash);
+    if (bloom_precisa_crescer(filtro)) lista_bloom_crescer(filtro, *head);
     printf("[LISTA] Item inserido no inicio.\n");
 }
 
 /* LISTA: remover por nome */
-void lista_remover(No **head) {
+void lista_remover(No **head, FiltroBloom *filtro) {
     if (*head == NULL) { printf("[LISTA] Vazia.\n"); return; }
     char nome[TAM_NOME]; printf("[LISTA] Nome a remover: "); ler_linha_trim(nome, TAM_NOME);
     No *cur = *head, *prev = NULL;
+    AssinaturaNome an = assinar_nome(nome);
     comp_seq_lista = 0;
+    if (!bloom_talvez_contem(filtro, an.hash)) { printf("[LISTA] Nao encontrado (filtro de Bloom). Comparacoes: 0\n"); return; }
     while (cur) {
         comp_seq_lista++;
-        if (strcmp(cur->dados.nome, nome) == 0) {
+        if (nome_igual(cur->dados.nome, cur->dados.assinatura, nome, an)) {
+            bloom_remover(filtro, cur->dados.assinatura.hash);
             if (prev) prev->proximo = cur->proximo; else *head = cur->proximo;
             free(cur);
             printf("[LISTA] Removido. Comparacoes: %lld\n", comp_seq_lista);
@@ -297,6 +1125,7 @@ void lista_remover(No **head) {
         }
         prev = cur; cur = cur->proximo;
     }
+    bloom_registrar_falso_positivo(filtro);
     printf("[LISTA] Nao encontrado. Comparacoes: %lld\n", comp_seq_lista);
 }
 
@@ -304,9 +1133,9 @@ void lista_remover(No **head) {
 void lista_listar(No *head) {
     separador(); printf("[LISTA] Itens:\n");
     if (!head) { printf("Vazia.\n"); return; }
-    int i = 1;
+    size_t i = 1;
     for (No *p = head; p; p = p->proximo) {
-        printf("%d) Nome: %s | Tipo: %s | Qt: %d\n", i++, p->dados.nome, p->dados.tipo, p->dados.quantidade);
+        printf("%zu) Nome: %s | Tipo: %s | Qt: %d\n", i++, p->dados.nome, p->dados.tipo, p->dados.quantidade);
     }
 }
 
@@ -316,18 +1145,94 @@ void lista_busca_sequencial(No *head) {
     char nome[TAM_NOME]; printf("[LISTA] Nome pra buscar: "); ler_linha_trim(nome, TAM_NOME);
     comp_seq_lista = 0;
     clock_t t0 = clock();
-    int pos = 0;
+    AssinaturaNome an = assinar_nome(nome);
+    size_t pos = 0;
+    No *achado = NULL;
+    hw_iniciar();
     for (No *p = head; p; p = p->proximo) {
         comp_seq_lista++; pos++;
-        if (strcmp(p->dados.nome, nome) == 0) {
-            clock_t t1 = clock(); double ms = (double)(t1 - t0) * 1000.0 / CLOCKS_PER_SEC;
-            printf("[LISTA] Encontrado pos %d. Comparacoes: %lld | Tempo: %.3f ms\n", pos-1, comp_seq_lista, ms);
-            printf("Detalhe: Nome:%s Tipo:%s Qt:%d\n", p->dados.nome, p->dados.tipo, p->dados.quantidade);
-            return;
-        }
+        if (nome_igual(p->dados.nome, p->dados.assinatura, nome, an)) { achado = p; break; }
     }
+    hw_parar(MED_LISTA_SEQ);
     clock_t t1 = clock(); double ms = (double)(t1 - t0) * 1000.0 / CLOCKS_PER_SEC;
-    printf("[LISTA] Nao encontrado. Comparacoes: %lld | Tempo: %.3f ms\n", comp_seq_lista, ms);
+    if (achado) {
+        printf("[LISTA] Encontrado pos %zu. Comparacoes: %lld | Tempo: %.3f ms\n", pos-1, comp_seq_lista, ms);
+        printf("Detalhe: Nome:%s Tipo:%s Qt:%d\n", achado->dados.nome, achado->dados.tipo, achado->dados.quantidade);
+    } else printf("[LISTA] Nao encontrado. Comparacoes: %lld | Tempo: %.3f ms\n", comp_seq_lista, ms);
+}
+
+/*
+ * LISTA: merge sort bottom-up que so reencadeia os nos (O(1) de memoria
+ * extra, sem recursao). A cada passada intercala pares de sublistas de
+ * tamanho 'largura' (1, 2, 4, ...) ate sobrar uma so. Estavel: itens com a
+ * mesma chave mantem a ordem da lista.
+ */
+typedef enum { ITEM_POR_NOME = 1, ITEM_POR_TIPO, ITEM_POR_QUANTIDADE } CriterioItem;
+
+int item2_comparar(const Item2 *a, const Item2 *b, CriterioItem crit) {
+    if (crit == ITEM_POR_TIPO) return strcmp(a->tipo, b->tipo);
+    if (crit == ITEM_POR_QUANTIDADE) return (a->quantidade > b->quantidade) - (a->quantidade < b->quantidade);
+    return strcmp(a->nome, b->nome);
+}
+
+/* Corta a lista depois dos primeiros k nos de p e devolve o restante */
+No *lista_cortar(No *p, size_t k) {
+    for (size_t i = 1; p && i < k; ++i) p = p->proximo;
+    if (!p) return NULL;
+    No *resto = p->proximo;
+    p->proximo = NULL;
+    return resto;
+}
+
+/* Intercala a e b (ja ordenadas) depois de cauda; devolve o novo ultimo no */
+No *lista_intercalar(No *a, No *b, No *cauda, CriterioItem crit, long long *comparacoes) {
+    while (a && b) {
+        (*comparacoes)++;
+        if (item2_comparar(&b->dados, &a->dados, crit) < 0) { cauda->proximo = b; b = b->proximo; }
+        else { cauda->proximo = a; a = a->proximo; }
+        cauda = cauda->proximo;
+    }
+    cauda->proximo = a ? a : b;
+    while (cauda->proximo) cauda = cauda->proximo;
+    return cauda;
+}
+
+/* Ordena *head pelo criterio; devolve as comparacoes */
+long long lista_merge_sort(No **head, CriterioItem crit) {
+    long long comparacoes = 0;
+    No inicio; /* sentinela: a cabeca pode mudar a cada passada */
+    inicio.proximo = *head;
+    for (size_t largura = 1; ; largura *= 2) {
+        No *cur = inicio.proximo, *cauda = &inicio;
+        size_t intercalacoes = 0;
+        while (cur) {
+            No *a = cur;
+            No *b = lista_cortar(a, largura);
+            cur = lista_cortar(b, largura);
+            cauda = lista_intercalar(a, b, cauda, crit, &comparacoes);
+            intercalacoes++;
+        }
+        if (intercalacoes <= 1) break;
+    }
+    *head = inicio.proximo;
+    return comparacoes;
+}
+
+/* LISTA: ordenar por nome, tipo ou quantidade (mesmos contadores do vetor) */
+void lista_ordenar(No **head) {
+    if (!*head || !(*head)->proximo) { printf("[LISTA] Nada a ordenar.\n"); return; }
+    printf("[LISTA] Ordenar por: 1- Nome 2- Tipo 3- Quantidade: ");
+    int c;
+    if (entrada_ler_int(&c) != 1 || c < ITEM_POR_NOME || c > ITEM_POR_QUANTIDADE) { limpar_buffer(); printf("Criterio invalido.\n"); return; }
+    limpar_buffer();
+    static const char *nomes[] = { "", "nome", "tipo", "quantidade" };
+    clock_t t0 = clock();
+    hw_iniciar();
+    comp_ord_lista = lista_merge_sort(head, (CriterioItem)c);
+    hw_parar(MED_LISTA_ORD);
+    clock_t t1 = clock();
+    double ms = (double)(t1 - t0) * 1000.0 / CLOCKS_PER_SEC;
+    printf("[LISTA] Ordenada por %s (Merge bottom-up). Comparacoes: %lld | Tempo: %.3f ms\n", nomes[c], comp_ord_lista, ms);
 }
 
 /* Lista liberar */
@@ -337,81 +1242,718 @@ void lista_liberar(No **head) {
     *head = NULL;
 }
 
-/* Menu do módulo 2 */
-void modulo2() {
-    VetorDyn v; vetor_init(&v);
-    No *head = NULL;
-    int opc;
-    do {
-        separador();
-        printf("MÓDULO 2 - Comparativo Vetor Dinamico x Lista Encadeada\n");
-        printf("1- Inserir (vetor)  2- Remover (vetor)  3- Listar (vetor)\n");
-        printf("4- Busca sequencial (vetor) 5- Ordenar por nome (vetor) 6- Busca binaria (vetor)\n");
-        printf("7- Inserir (lista) 8- Remover (lista) 9- Listar (lista)\n");
-        printf("10- Busca sequencial (lista)\n");
-        printf("11- Mostrar contadores (comparacoes)\n");
-        printf("0- Voltar\nEscolha: ");
-        if (scanf("%d", &opc) != 1) { limpar_buffer(); opc = -1; }
-        limpar_buffer();
-        switch (opc) {
-            case 1: vetor_inserir(&v); break;
-            case 2: vetor_remover(&v); break;
-            case 3: vetor_listar(&v); break;
-            case 4: vetor_busca_sequencial(&v); break;
-            case 5: vetor_ordenar_nome(&v); break;
-            case 6: vetor_busca_binaria(&v); break;
-            case 7: lista_inserir(&head); break;
-            case 8: lista_remover(&head); break;
-            case 9: lista_listar(head); break;
-            case 10: lista_busca_sequencial(head); break;
-            case 11:
-                printf("\nComparacoes (vetor - sequencial): %lld\n", comp_seq_vetor);
-                printf("Comparacoes (vetor - binaria): %lld\n", comp_bin_vetor);
-                printf("Comparacoes (lista - sequencial): %lld\n", comp_seq_lista);
-                break;
-            case 0: break;
-            default: printf("Opcao invalida.\n");
-        }
-    } while (opc != 0);
-
-    free(v.itens);
-    lista_liberar(&head);
-}
+/*
+ * SKIP LIST: lista encadeada ordenada por nome com niveis de atalho.
+ * Cada no sobe para o nivel seguinte com probabilidade 1/4 (media de 1.33
+ * ponteiros por no); a busca desce do nivel mais alto pulando blocos, entao
+ * inserir, buscar e remover custam O(log n) comparacoes esperadas.
+ * Nomes repetidos sao aceitos (entram depois dos iguais); buscar/remover
+ * pegam o primeiro.
+ */
+#define SKIP_NIVEL_MAX 16 /* 4^16 nos antes de perder eficiencia */
 
-/* =====================================
-   MÓDULO 3: Torre de Fuga (componentes)
-   - até 20 componentes
-   - bubble por nome, insertion por tipo, selection por prioridade
-   - busca binária por nome (após ordenar por nome)
-   ===================================== */
-#define MOD3_MAX 20
+typedef struct NoSkip {
+    Item2 dados;
+    int nivel;
+    struct NoSkip *prox[]; /* prox[0..nivel) */
+} NoSkip;
 
 typedef struct {
-    char nome[TAM_NOME];
-    char tipo[TAM_TIPO];
-    int prioridade; /* 1..10 */
-} Componente;
+    NoSkip *cabeca; /* sentinela com SKIP_NIVEL_MAX ponteiros */
+    int nivel;      /* niveis em uso */
+    size_t tamanho;
+    size_t ponteiros; /* soma dos niveis dos nos (memoria de atalhos) */
+    uint32_t semente;
+} ListaSkip;
 
-void mod3_mostrar(Componente comps[], int n) {
-    separador();
-    printf("Componentes (%d):\n", n);
+long long comp_skip_lista = 0;
+
+NoSkip *skip_novo_no(int nivel) {
+    NoSkip *n = malloc(sizeof(NoSkip) + sizeof(NoSkip *) * (size_t)nivel);
+    if (!n) { fprintf(stderr, "Memoria insuficiente\n"); exit(1); }
+    n->nivel = nivel;
+    for (int i = 0; i < nivel; ++i) n->prox[i] = NULL;
+    return n;
+}
+
+void skip_init(ListaSkip *s) {
+    s->cabeca = skip_novo_no(SKIP_NIVEL_MAX);
+    s->nivel = 1;
+    s->tamanho = 0;
+    s->ponteiros = 0;
+    s->semente = 2463534242u; /* xorshift32: deterministico entre execucoes */
+}
+
+/* 1 + numero de "caras" seguidas com moeda de 1/4 */
+int skip_sortear_nivel(ListaSkip *s) {
+    uint32_t x = s->semente;
+    x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+    s->semente = x;
+    int nivel = 1;
+    while (nivel < SKIP_NIVEL_MAX && (x & 3u) == 0) { nivel++; x >>= 2; }
+    return nivel;
+}
+
+/*
+ * Desce os niveis parando antes do primeiro nome >= chave; anteriores[i]
+ * recebe o ultimo no do nivel i antes da posicao. Devolve o candidato do
+ * nivel 0 (primeiro nome >= chave ou NULL).
+ */
+NoSkip *skip_descer(ListaSkip *s, const char *nome, NoSkip *anteriores[], long long *comparacoes) {
+    NoSkip *p = s->cabeca, *barreira = NULL; /* no ja comparado num nivel de cima */
+    for (int i = s->nivel - 1; i >= 0; --i) {
+        while (p->prox[i] && p->prox[i] != barreira) {
+            (*comparacoes)++;
+            if (strcmp(p->prox[i]->dados.nome, nome) >= 0) { barreira = p->prox[i]; break; }
+            p = p->prox[i];
+        }
+        if (anteriores) anteriores[i] = p;
+    }
+    return p->prox[0];
+}
+
+/* Encadeia o item na posicao ordenada (depois dos nomes iguais) */
+void skip_inserir_item(ListaSkip *s, const Item2 *it, long long *comparacoes) {
+    NoSkip *anteriores[SKIP_NIVEL_MAX];
+    NoSkip *p = s->cabeca, *barreira = NULL;
+    for (int i = s->nivel - 1; i >= 0; --i) {
+        while (p->prox[i] && p->prox[i] != barreira) {
+            (*comparacoes)++;
+            if (strcmp(p->prox[i]->dados.nome, it->nome) > 0) { barreira = p->prox[i]; break; }
+            p = p->prox[i];
+        }
+        anteriores[i] = p;
+    }
+    int nivel = skip_sortear_nivel(s);
+    for (int i = s->nivel; i < nivel; ++i) anteriores[i] = s->cabeca;
+    if (nivel > s->nivel) s->nivel = nivel;
+    NoSkip *n = skip_novo_no(nivel);
+    n->dados = *it;
+    for (int i = 0; i < nivel; ++i) { n->prox[i] = anteriores[i]->prox[i]; anteriores[i]->prox[i] = n; }
+    s->tamanho++;
+    s->ponteiros += (size_t)nivel;
+}
+
+/* Primeiro no com o nome, ou NULL */
+NoSkip *skip_buscar(ListaSkip *s, const char *nome, long long *comparacoes) {
+    NoSkip *c = skip_descer(s, nome, NULL, comparacoes);
+    if (!c) return NULL;
+    (*comparacoes)++;
+    return strcmp(c->dados.nome, nome) == 0 ? c : NULL;
+}
+
+/* 1 = removeu o primeiro item com o nome */
+int skip_remover_nome(ListaSkip *s, const char *nome, long long *comparacoes) {
+    NoSkip *anteriores[SKIP_NIVEL_MAX];
+    NoSkip *c = skip_descer(s, nome, anteriores, comparacoes);
+    if (!c) return 0;
+    (*comparacoes)++;
+    if (strcmp(c->dados.nome, nome) != 0) return 0;
+    /* c e o primeiro igual: em todos os niveis dele o anterior aponta para c */
+    for (int i = 0; i < c->nivel; ++i) anteriores[i]->prox[i] = c->prox[i];
+    while (s->nivel > 1 && !s->cabeca->prox[s->nivel - 1]) s->nivel--;
+    s->tamanho--;
+    s->ponteiros -= (size_t)c->nivel;
+    free(c);
+    return 1;
+}
+
+void skip_liberar(ListaSkip *s) {
+    NoSkip *cur = s->cabeca->prox[0];
+    while (cur) { NoSkip *tmp = cur; cur = cur->prox[0]; free(tmp); }
+    free(s->cabeca);
+    s->cabeca = NULL;
+    s->tamanho = s->ponteiros = 0;
+}
+
+/* SKIP: inserir em ordem */
+void skip_inserir(ListaSkip *s) {
+    Item2 it;
+    printf("[SKIP] Nome: "); ler_linha_trim(it.nome, TAM_NOME);
+    printf("[SKIP] Tipo: "); ler_linha_trim(it.tipo, TAM_TIPO);
+    printf("[SKIP] Quantidade: "); if (entrada_ler_int(&it.quantidade) != 1) { limpar_buffer(); printf("Entrada invalida.\n"); return; }
+    limpar_buffer();
+    it.assinatura = assinar_nome(it.nome);
+    comp_skip_lista = 0;
+    skip_inserir_item(s, &it, &comp_skip_lista);
+    printf("[SKIP] Item inserido em ordem. Tamanho agora: %zu | Comparacoes: %lld\n", s->tamanho, comp_skip_lista);
+}
+
+/* SKIP: remover por nome */
+void skip_remover(ListaSkip *s) {
+    if (s->tamanho == 0) { printf("[SKIP] Vazia.\n"); return; }
+    char nome[TAM_NOME]; printf("[SKIP] Nome a remover: "); ler_linha_trim(nome, TAM_NOME);
+    comp_skip_lista = 0;
+    if (skip_remover_nome(s, nome, &comp_skip_lista)) printf("[SKIP] Removido. Comparacoes: %lld\n", comp_skip_lista);
+    else printf("[SKIP] Nao encontrado. Comparacoes: %lld\n", comp_skip_lista);
+}
+
+/* SKIP: listar (ja sai ordenado por nome) */
+void skip_listar(const ListaSkip *s) {
+    separador(); printf("[SKIP] Itens (%zu, ordenados por nome, %d niveis)\n", s->tamanho, s->nivel);
+    if (s->tamanho == 0) { printf("Vazia.\n"); return; }
+    size_t i = 1;
+    for (NoSkip *p = s->cabeca->prox[0]; p; p = p->prox[0])
+        printf("%zu) Nome: %s | Tipo: %s | Qt: %d | Nivel: %d\n", i++, p->dados.nome, p->dados.tipo, p->dados.quantidade, p->nivel);
+}
+
+/* SKIP: busca O(log n) esperado */
+void skip_busca(ListaSkip *s) {
+    if (s->tamanho == 0) { printf("[SKIP] Vazia.\n"); return; }
+    char nome[TAM_NOME]; printf("[SKIP] Nome pra buscar: "); ler_linha_trim(nome, TAM_NOME);
+    comp_skip_lista = 0;
+    clock_t t0 = clock();
+    hw_iniciar();
+    NoSkip *achado = skip_buscar(s, nome, &comp_skip_lista);
+    hw_parar(MED_SKIP_BUSCA);
+    clock_t t1 = clock(); double ms = (double)(t1 - t0) * 1000.0 / CLOCKS_PER_SEC;
+    if (achado) {
+        printf("[SKIP] Encontrado. Comparacoes: %lld | Tempo: %.3f ms\n", comp_skip_lista, ms);
+        printf("Detalhe: Nome:%s Tipo:%s Qt:%d\n", achado->dados.nome, achado->dados.tipo, achado->dados.quantidade);
+    } else printf("[SKIP] Nao encontrado. Comparacoes: %lld | Tempo: %.3f ms\n", comp_skip_lista, ms);
+}
+
+void skip_mostrar_memoria(const ListaSkip *s) {
+    size_t bytes = s->tamanho * sizeof(NoSkip) + (s->ponteiros + SKIP_NIVEL_MAX) * sizeof(NoSkip *) + sizeof(NoSkip);
+    printf("Memoria (skip list): %zu nos | %zu ponteiros de atalho (%.2f por no) | %zu B sem overhead do malloc\n",
+           s->tamanho, s->ponteiros, s->tamanho ? (double)s->ponteiros / (double)s->tamanho : 0.0, bytes);
+}
+
+/*
+ * Benchmark de busca com os mesmos n itens nas tres estruturas: vetor
+ * (sequencial e binaria apos ordenar), lista encadeada e skip list.
+ * Metade das consultas e por nomes ausentes.
+ */
+#define BENCH_BUSCA_CONSULTAS 2000
+
+void benchmark_busca_estruturas() {
+    printf("Quantidade de itens (ex: 20000): ");
+    size_t n; if (entrada_ler_size(&n) != 1 || n == 0) { limpar_buffer(); printf("Entrada invalida.\n"); return; }
+    limpar_buffer();
+    Item2 *itens = n <= SIZE_MAX / sizeof(Item2) ? malloc(sizeof(Item2) * n) : NULL;
+    if (!itens) { printf("[BENCH] Memoria insuficiente.\n"); return; }
+    ListaSkip s; skip_init(&s);
+    No *head = NULL;
+    long long comp_ins = 0;
+    for (size_t i = 0; i < n; ++i) {
+        Item2 *it = &itens[i];
+        snprintf(it->nome, TAM_NOME, "Item %zu", (i * 2654435761u) % n); /* ordem embaralhada */
+        snprintf(it->tipo, TAM_TIPO, "Bench");
+        it->quantidade = 1;
+        it->assinatura = assinar_nome(it->nome);
+        skip_inserir_item(&s, it, &comp_ins);
+        No *no = malloc(sizeof(No));
+        if (!no) { fprintf(stderr, "Memoria insuficiente\n"); exit(1); }
+        no->dados = *it; no->proximo = head; head = no;
+    }
+    Item2 *ordenados = malloc(sizeof(Item2) * n);
+    if (!ordenados) { fprintf(stderr, "Memoria insuficiente\n"); exit(1); }
+    size_t k = 0;
+    for (NoSkip *p = s.cabeca->prox[0]; p; p = p->prox[0]) ordenados[k++] = p->dados; /* nivel 0 ja e ordenado */
+
+    long long comp[4] = { 0, 0, 0, 0 }, achados[4] = { 0, 0, 0, 0 };
+    double ms[4];
+    char busca[TAM_NOME];
+    for (int e = 0; e < 4; ++e) {
+        clock_t t0 = clock();
+        for (size_t q = 0; q < BENCH_BUSCA_CONSULTAS; ++q) {
+            snprintf(busca, TAM_NOME, "Item %zu", (q % 2) ? (q * 7919) % n : n + q);
+            AssinaturaNome ab = assinar_nome(busca);
+            if (e == 0) {
+                for (size_t i = 0; i < n; ++i) { comp[e]++; if (nome_igual_puro(itens[i].nome, itens[i].assinatura, busca, ab)) { achados[e]++; break; } }
+            } else if (e == 1) {
+                for (No *p = head; p; p = p->proximo) { comp[e]++; if (nome_igual_puro(p->dados.nome, p->dados.assinatura, busca, ab)) { achados[e]++; break; } }
+            } else if (e == 2) {
+                size_t l = 0, r = n;
+                while (l < r) {
+                    size_t mid = l + (r - l) / 2;
+                    comp[e]++;
+                    int cmp = strcmp(ordenados[mid].nome, busca);
+                    if (cmp == 0) { achados[e]++; break; }
+                    if (cmp < 0) l = mid + 1; else r = mid;
+                }
+            } else if (skip_buscar(&s, busca, &comp[e])) achados[e]++;
+        }
+        ms[e] = (double)(clock() - t0) * 1000.0 / CLOCKS_PER_SEC;
+    }
+    static const char *nomes[4] = { "vetor sequencial", "lista sequencial", "vetor binaria", "skip list" };
+    printf("[BENCH] %zu itens, %d consultas (50%% ausentes); skip list com %d niveis, %lld comparacoes para montar\n",
+           n, BENCH_BUSCA_CONSULTAS, s.nivel, comp_ins);
+    for (int e = 0; e < 4; ++e)
+        printf("[BENCH] %-17s %10.3f ms | comparacoes/consulta: %10.1f | achados: %lld\n",
+               nomes[e], ms[e], (double)comp[e] / BENCH_BUSCA_CONSULTAS, achados[e]);
+    free(ordenados);
+    free(itens);
+    lista_liberar(&head);
+    skip_liberar(&s);
+}
+
+/*
+ * Benchmark das assinaturas: gera nomes com prefixos comuns do jogo e
+ * compara a busca sequencial so com strcmp contra a que rejeita por
+ * tamanho/hash antes. Metade das consultas e por nomes ausentes.
+ */
+/* Consultas impares existem no inventario; pares usam indice >= n (ausentes) */
+void bench_nome_consulta(char *busca, const char *prefixos[], size_t nprefixos, size_t n, size_t q) {
+    size_t idx = (q % 2) ? (q * 7919) % n : n + q;
+    snprintf(busca, TAM_NOME, "%s%zu", prefixos[idx % nprefixos], idx);
+}
+
+void benchmark_assinaturas() {
+    static const char *prefixos[] = {
+        "Kit medico ", "Kit reparo ", "Kit de cura ", "Municao 5.56 ", "Municao 7.62 ",
+        "Municao 9mm ", "Municao 12 ", "Granada ", "Colete nivel ", "Capacete nivel "
+    };
+    const size_t nprefixos = sizeof prefixos / sizeof prefixos[0];
+    printf("Quantidade de itens (ex: 5000): ");
+    size_t n; if (entrada_ler_size(&n) != 1 || n == 0) { limpar_buffer(); printf("Entrada invalida.\n"); return; }
+    limpar_buffer();
+    const size_t consultas = 2000;
+
+    Item2 *itens = n <= SIZE_MAX / sizeof(Item2) ? malloc(sizeof(Item2) * n) : NULL;
+    if (!itens) { printf("[BENCH] Memoria insuficiente.\n"); return; }
+    for (size_t i = 0; i < n; ++i) {
+        snprintf(itens[i].nome, TAM_NOME, "%s%zu", prefixos[i % nprefixos], i);
+        itens[i].assinatura = assinar_nome(itens[i].nome);
+    }
+
+    long long achados_strcmp = 0, achados_assin = 0, strcmp_simples = 0;
+    char busca[TAM_NOME];
+
+    clock_t t0 = clock();
+    for (size_t q = 0; q < consultas; ++q) {
+        bench_nome_consulta(busca, prefixos, nprefixos, n, q);
+        for (size_t i = 0; i < n; ++i) { strcmp_simples++; if (strcmp(itens[i].nome, busca) == 0) { achados_strcmp++; break; } }
+    }
+    clock_t t1 = clock();
+    long long antes = strcmp_igualdade;
+    for (size_t q = 0; q < consultas; ++q) {
+        bench_nome_consulta(busca, prefixos, nprefixos, n, q);
+        AssinaturaNome ab = assinar_nome(busca);
+        for (size_t i = 0; i < n; ++i) if (nome_igual(itens[i].nome, itens[i].assinatura, busca, ab)) { achados_assin++; break; }
+    }
+    clock_t t2 = clock();
+    double ms_strcmp = (double)(t1 - t0) * 1000.0 / CLOCKS_PER_SEC;
+    double ms_assin = (double)(t2 - t1) * 1000.0 / CLOCKS_PER_SEC;
+
+    printf("[BENCH] %zu itens, %zu consultas (50%% ausentes)\n", n, consultas);
+    printf("[BENCH] So strcmp:      %.3f ms | strcmp executados: %lld | achados: %lld\n", ms_strcmp, strcmp_simples, achados_strcmp);
+    printf("[BENCH] Tamanho + hash: %.3f ms | strcmp executados: %lld | achados: %lld\n", ms_assin, strcmp_igualdade - antes, achados_assin);
+    free(itens);
+}
+
+/*
+ * Demonstracao: leitores em threads renderizam versoes publicadas enquanto o
+ * escritor reescreve o seu vetor e publica de novo a cada rodada. Cada rodada
+ * grava a mesma geracao em todos os itens e um tamanho derivado dela; uma
+ * leitura rasgada apareceria como geracoes misturadas ou tamanho errado.
+ */
+#define DEMO_COW_BASE 2000
+#define DEMO_COW_RODADAS 3000
+#define DEMO_COW_LEITORES 3
+
+#ifdef TEM_PTHREAD
+typedef struct {
+    CanalCow *canal;
+    atomic_int *parar;
+    long long leituras, itens_lidos, rasgadas;
+} LeitorDemo;
+
+void *demo_leitor(void *arg) {
+    LeitorDemo *l = arg;
+    int s = cow_leitor_entrar(l->canal);
+    if (s < 0) return NULL;
+    char linha[96];
+    while (!atomic_load(l->parar)) {
+        const VersaoCow *f = cow_ler(l->canal, s);
+        if (f && f->tamanho) {
+            const Item2 *it = COW_ITENS(f, Item2);
+            int geracao = it[0].quantidade;
+            if (f->tamanho != DEMO_COW_BASE + (size_t)(geracao % 100)) l->rasgadas++;
+            for (size_t i = 0; i < f->tamanho; ++i) {
+                snprintf(linha, sizeof linha, "%zu) Nome: %s | Tipo: %s | Qt: %d", i+1, it[i].nome, it[i].tipo, it[i].quantidade);
+                if (it[i].quantidade != geracao) { l->rasgadas++; break; }
+            }
+            l->itens_lidos += (long long)f->tamanho;
+            l->leituras++;
+        }
+        cow_soltar(l->canal, s);
+    }
+    cow_leitor_sair(l->canal, s);
+    return NULL;
+}
+#endif
+
+void demo_listagem_concorrente() {
+#ifdef TEM_PTHREAD
+    const size_t max = DEMO_COW_BASE + 100;
+    Item2 *itens = malloc(sizeof(Item2) * max);
+    if (!itens) { printf("[COW] Memoria insuficiente.\n"); return; }
+    for (size_t i = 0; i < max; ++i) {
+        snprintf(itens[i].nome, TAM_NOME, "Item %zu", i);
+        snprintf(itens[i].tipo, TAM_TIPO, "demo");
+        itens[i].assinatura = assinar_nome(itens[i].nome);
+    }
+    CanalCow canal; cow_init(&canal);
+    atomic_int parar; atomic_init(&parar, 0);
+    LeitorDemo leitores[DEMO_COW_LEITORES];
+    pthread_t th[DEMO_COW_LEITORES];
+    int criadas = 0;
+    for (int i = 0; i < DEMO_COW_LEITORES; ++i) {
+        leitores[i] = (LeitorDemo){ &canal, &parar, 0, 0, 0 };
+        if (pthread_create(&th[i], NULL, demo_leitor, &leitores[i]) == 0) criadas++;
+        else break;
+    }
+
+    clock_t t0 = clock();
+    for (int g = 1; g <= DEMO_COW_RODADAS; ++g) {
+        size_t n = DEMO_COW_BASE + (size_t)(g % 100);
+        for (size_t i = 0; i < n; ++i) itens[i].quantidade = g; /* escrita no vetor de trabalho */
+        if (!cow_publicar(&canal, itens, n, sizeof(Item2))) { printf("[COW] Memoria insuficiente.\n"); break; }
+    }
+    clock_t t1 = clock();
+    atomic_store(&parar, 1);
+    for (int i = 0; i < criadas; ++i) pthread_join(th[i], NULL);
+
+    long long leituras = 0, lidos = 0, rasgadas = 0;
+    for (int i = 0; i < criadas; ++i) {
+        leituras += leitores[i].leituras; lidos += leitores[i].itens_lidos; rasgadas += leitores[i].rasgadas;
+    }
+    printf("[COW] %d leitores x escritor, %d rodadas de ~%d itens (%.3f ms de CPU)\n",
+           criadas, DEMO_COW_RODADAS, DEMO_COW_BASE, (double)(t1 - t0) * 1000.0 / CLOCKS_PER_SEC);
+    printf("[COW] Listagens completas: %lld | itens renderizados: %lld | leituras rasgadas: %lld\n", leituras, lidos, rasgadas);
+    printf("[COW] Versoes publicadas: %zu | recuperadas: %zu | retidas por leitores (pico): %zu\n",
+           canal.publicadas, canal.recuperadas, canal.pico_pendentes);
+    cow_liberar(&canal);
+    free(itens);
+#else
+    printf("[COW] Demonstracao requer pthreads.\n");
+#endif
+}
+
+/*
+ * Stress + vazao das buscas concorrentes (1 escritor, 1..8 leitores).
+ * O escritor alterna nomes "Volatil" (remove se existe, senao insere na
+ * posicao ordenada) com uma pausa fixa entre mutacoes; os leitores buscam nomes "Estavel" (que
+ * nunca saem: nao achar ou achar com dados errados conta como erro) e
+ * "Volatil". Compara o caminho sem trava (versao publicada) com um
+ * rwlock sobre o vetor vivo; a coluna de mutacoes/s mostra se o escritor
+ * consegue avancar com muitos leitores.
+ */
+#define STRESS_ESTAVEIS 4096
+#define STRESS_VOLATEIS 1024
+#define STRESS_MAX_LEITORES 8
+#define STRESS_DURACAO_MS 250
+#define STRESS_PAUSA_ESCRITOR_US 50 /* entre mutacoes: mesma carga de escrita nos dois modos */
+
+#ifdef TEM_PTHREAD
+typedef struct {
+    VetorCrescente trabalho;    /* Item2 ordenado por nome (do escritor) */
+    CanalCow canal;             /* modo sem trava */
+    pthread_rwlock_t trava;     /* modo com trava: leitores usam 'trabalho' direto */
+    int com_trava;
+    atomic_int parar;
+    long long mutacoes;
+} StressBusca;
+
+typedef struct {
+    StressBusca *sb;
+    uint64_t semente;
+    long long buscas, achados, erros;
+} LeitorStress;
+
+void stress_nome(char *nome, int volatil, unsigned k) {
+    snprintf(nome, TAM_NOME, volatil ? "Volatil %05u" : "Estavel %05u", k);
+}
+
+size_t stress_posicao(const VetorCrescente *v, const char *nome, int *achou) {
+    const Item2 *it = VC_ITENS(v, const Item2);
+    size_t l = 0, r = v->tamanho;
+    while (l < r) {
+        size_t mid = l + (r - l) / 2;
+        int cmp = strcmp(it[mid].nome, nome);
+        if (cmp == 0) { *achou = 1; return mid; }
+        if (cmp < 0) l = mid + 1; else r = mid;
+    }
+    *achou = 0;
+    return l;
+}
+
+void *stress_escritor(void *arg) {
+    StressBusca *sb = arg;
+    uint64_t x = 0x2545F4914F6CDD1Dull;
+    char nome[TAM_NOME];
+    struct timespec pausa = { 0, STRESS_PAUSA_ESCRITOR_US * 1000L };
+    while (!atomic_load(&sb->parar)) {
+        nanosleep(&pausa, NULL);
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        unsigned k = (unsigned)(x % STRESS_VOLATEIS);
+        stress_nome(nome, 1, k);
+        if (sb->com_trava) pthread_rwlock_wrlock(&sb->trava);
+        int achou; size_t pos = stress_posicao(&sb->trabalho, nome, &achou);
+        if (achou) vc_remover(&sb->trabalho, pos);
+        else if (vc_garantir(&sb->trabalho, sb->trabalho.tamanho + 1)) {
+            Item2 *it = VC_ITENS(&sb->trabalho, Item2);
+            memmove(&it[pos + 1], &it[pos], sizeof(Item2) * (sb->trabalho.tamanho - pos));
+            memcpy(it[pos].nome, nome, TAM_NOME);
+            snprintf(it[pos].tipo, TAM_TIPO, "volatil");
+            it[pos].quantidade = (int)k;
+            it[pos].assinatura = assinar_nome(nome);
+            sb->trabalho.tamanho++;
+        }
+        if (sb->com_trava) pthread_rwlock_unlock(&sb->trava);
+        else cow_publicar_marcado(&sb->canal, sb->trabalho.dados, sb->trabalho.tamanho, sizeof(Item2), COW_ORDENADA);
+        sb->mutacoes++;
+    }
+    return NULL;
+}
+
+void *stress_leitor(void *arg) {
+    LeitorStress *l = arg;
+    StressBusca *sb = l->sb;
+    int slot = sb->com_trava ? 0 : cow_leitor_entrar(&sb->canal);
+    if (slot < 0) return NULL;
+    uint64_t x = l->semente | 1;
+    char nome[TAM_NOME];
+    Item2 achado;
+    while (!atomic_load(&sb->parar)) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        int volatil = (x >> 60) == 0; /* 1 em 16 buscas e por nome volatil */
+        unsigned k = (unsigned)((x >> 8) % (volatil ? STRESS_VOLATEIS : STRESS_ESTAVEIS));
+        stress_nome(nome, volatil, k);
+        int ok;
+        if (sb->com_trava) {
+            pthread_rwlock_rdlock(&sb->trava);
+            int achou; size_t pos = stress_posicao(&sb->trabalho, nome, &achou);
+            if (achou) achado = VC_ITENS(&sb->trabalho, Item2)[pos];
+            pthread_rwlock_unlock(&sb->trava);
+            ok = achou;
+        } else {
+            ok = vetor_buscar_sem_trava(&sb->canal, slot, nome, &achado);
+        }
+        l->buscas++;
+        if (ok) {
+            l->achados++;
+            if (achado.quantidade != (int)k || strcmp(achado.nome, nome) != 0) l->erros++;
+        } else if (!volatil) {
+            l->erros++; /* estavel sempre presente */
+        }
+    }
+    if (!sb->com_trava) cow_leitor_sair(&sb->canal, slot);
+    return NULL;
+}
+
+/* Uma rodada: monta o vetor, dispara escritor + leitores por STRESS_DURACAO_MS */
+void stress_rodada(int com_trava, int nleitores) {
+    StressBusca sb;
+    vc_init(&sb.trabalho, sizeof(Item2));
+    if (!vc_garantir(&sb.trabalho, STRESS_ESTAVEIS + STRESS_VOLATEIS)) { printf("[STRESS] Memoria insuficiente.\n"); return; }
+    Item2 *it = VC_ITENS(&sb.trabalho, Item2);
+    for (unsigned k = 0; k < STRESS_ESTAVEIS; ++k) { /* "Estavel 00000".. ja sai ordenado */
+        stress_nome(it[k].nome, 0, k);
+        snprintf(it[k].tipo, TAM_TIPO, "estavel");
+        it[k].quantidade = (int)k;
+        it[k].assinatura = assinar_nome(it[k].nome);
+    }
+    sb.trabalho.tamanho = STRESS_ESTAVEIS;
+    cow_init(&sb.canal);
+    cow_publicar_marcado(&sb.canal, sb.trabalho.dados, sb.trabalho.tamanho, sizeof(Item2), COW_ORDENADA);
+    pthread_rwlock_init(&sb.trava, NULL);
+    sb.com_trava = com_trava;
+    atomic_init(&sb.parar, 0);
+    sb.mutacoes = 0;
+
+    LeitorStress leitores[STRESS_MAX_LEITORES];
+    pthread_t th[STRESS_MAX_LEITORES], esc;
+    int criadas = 0, escritor = pthread_create(&esc, NULL, stress_escritor, &sb) == 0;
+    for (int i = 0; i < nleitores; ++i) {
+        leitores[i] = (LeitorStress){ &sb, 0x9E3779B97F4A7C15ull * (uint64_t)(i + 7), 0, 0, 0 };
+        if (pthread_create(&th[i], NULL, stress_leitor, &leitores[i]) != 0) break;
+        criadas++;
+    }
+    struct timespec espera = { 0, STRESS_DURACAO_MS * 1000000L };
+    double t0 = agora_s();
+    nanosleep(&espera, NULL);
+    atomic_store(&sb.parar, 1);
+    for (int i = 0; i < criadas; ++i) pthread_join(th[i], NULL);
+    if (escritor) pthread_join(esc, NULL);
+    double seg = agora_s() - t0;
+
+    long long buscas = 0, achados = 0, erros = 0;
+    for (int i = 0; i < criadas; ++i) { buscas += leitores[i].buscas; achados += leitores[i].achados; erros += leitores[i].erros; }
+    printf("[STRESS] %-9s %d leitores: %11.0f buscas/s | %9.0f mutacoes/s | razao %6.1f:1 | achados %lld | erros %lld\n",
+           com_trava ? "rwlock" : "sem trava", criadas, (double)buscas / seg, (double)sb.mutacoes / seg,
+           sb.mutacoes ? (double)buscas / (double)sb.mutacoes : 0.0, achados, erros);
+    pthread_rwlock_destroy(&sb.trava);
+    cow_liberar(&sb.canal);
+    vc_liberar(&sb.trabalho);
+}
+#endif
+
+void stress_buscas_concorrentes() {
+#ifdef TEM_PTHREAD
+    printf("[STRESS] %d nomes estaveis + ate %d volateis, %d ms por rodada\n", STRESS_ESTAVEIS, STRESS_VOLATEIS, STRESS_DURACAO_MS);
+    for (int nl = 1; nl <= STRESS_MAX_LEITORES; nl *= 2) {
+        stress_rodada(0, nl);
+        stress_rodada(1, nl);
+    }
+#else
+    printf("[STRESS] Requer pthreads.\n");
+#endif
+}
+
+/* Menu do módulo 2 */
+void modulo2() {
+    VetorDyn v; vetor_init(&v);
+    No *head = NULL;
+    FiltroBloom filtro_lista; bloom_init(&filtro_lista, BLOOM_CONTADORES_INICIAL);
+    ListaSkip skip; skip_init(&skip);
+#ifdef MC_DISPONIVEL
+    SegmentoMc espelho; espelho.cab = NULL; /* ligado pela opcao 23 */
+#endif
+#ifdef TEM_PTHREAD
+    Autosalvamento autosave; /* salva o vetor em AUTOSAVE_ARQUIVO sem travar o menu */
+    if (autosave_iniciar(&autosave, AUTOSAVE_ARQUIVO, AUTOSAVE_INTERVALO_MS)) v.autosave = &autosave;
+    else printf("[AUTOSAVE] Thread nao iniciou; o vetor nao sera salvo.\n");
+#endif
+    int opc;
+    int hw_eventos = hw_abrir();
+    do {
+        separador();
+        printf("MÓDULO 2 - Comparativo Vetor Dinamico x Lista Encadeada\n");
+        printf("1- Inserir (vetor)  2- Remover (vetor)  3- Listar (vetor)\n");
+        printf("4- Busca sequencial (vetor) 5- Ordenar por nome (vetor) 6- Busca binaria (vetor)\n");
+        printf("7- Inserir (lista) 8- Remover (lista) 9- Listar (lista)\n");
+        printf("10- Busca sequencial (lista)\n");
+        printf("11- Mostrar contadores (comparacoes + hardware) 12- Busca pelo indice Eytzinger (vetor)\n");
+        printf("13- Benchmark de igualdade (strcmp x tamanho+hash) 14- Liberar capacidade ociosa (vetor)\n");
+        printf("15- Listagem concorrente com versoes imutaveis (demo)  16- Buscas concorrentes sem trava (stress + vazao)\n");
+        printf("17- Inserir (skip list) 18- Remover (skip list) 19- Listar (skip list) 20- Busca (skip list)\n");
+        printf("21- Benchmark de busca (vetor x lista x skip list) 22- Ordenar (lista: nome/tipo/quantidade)\n");
+#ifdef MC_DISPONIVEL
+        printf("23- %s espelho do vetor em memoria compartilhada (espectadores)\n", espelho.cab ? "Desligar" : "Ligar");
+#endif
+#ifdef TEM_PTHREAD
+        printf("24- Autosalvamento: estado + salvar agora  25- Benchmark do autosalvamento (10^6 itens)\n");
+#endif
+        printf("0- Voltar\nEscolha: ");
+        { int r = entrada_ler_int(&opc); if (r != 1) opc = (r == EOF) ? 0 : -1; }
+        limpar_buffer();
+        switch (opc) {
+            case 1: vetor_inserir(&v); break;
+            case 2: vetor_remover(&v); break;
+            case 3: vetor_listar(&v); break;
+            case 4: vetor_busca_sequencial(&v); break;
+            case 5: vetor_ordenar_nome(&v); break;
+            case 6: vetor_busca_binaria(&v); break;
+            case 7: lista_inserir(&head, &filtro_lista); break;
+            case 8: lista_remover(&head, &filtro_lista); break;
+            case 9: lista_listar(head); break;
+            case 10: lista_busca_sequencial(head); break;
+            case 11:
+                printf("\nComparacoes (vetor - sequencial): %lld\n", comp_seq_vetor);
+                printf("Comparacoes (vetor - binaria): %lld\n", comp_bin_vetor);
+                printf("Comparacoes (lista - sequencial): %lld\n", comp_seq_lista);
+                printf("Comparacoes (vetor - indice Eytzinger): %lld\n", comp_eytz_vetor);
+                printf("Comparacoes (skip list - ultima operacao): %lld\n", comp_skip_lista);
+                printf("Comparacoes (vetor - ordenacao Selection): %lld\n", comp_ord_vetor);
+                printf("Comparacoes (lista - ordenacao Merge): %lld\n", comp_ord_lista);
+                bloom_mostrar(&v.filtro, "vetor");
+                bloom_mostrar(&filtro_lista, "lista");
+                printf("strcmp executados em igualdades (apos tamanho/hash): %lld\n", strcmp_igualdade);
+                vetor_mostrar_memoria(&v);
+                skip_mostrar_memoria(&skip);
+#ifdef MC_DISPONIVEL
+                if (espelho.cab)
+                    printf("Memoria compartilhada %s: %llu publicacoes | %zu B mapeados | %zu crescimentos | ultima copia %.4f ms\n",
+                           espelho.nome, (unsigned long long)atomic_load(&espelho.cab->publicacoes), espelho.bytes,
+                           espelho.crescimentos, espelho.ultima_publicacao_ms);
+#endif
+                printf("Contadores de hardware (ultima execucao, %d/%d eventos):\n", hw_eventos, HW_NEVENTOS);
+                hw_mostrar();
+                break;
+            case 12: vetor_busca_eytzinger(&v); break;
+            case 13: benchmark_assinaturas(); break;
+            case 14:
+                vetor_encolher(&v, 1);
+                vetor_mostrar_memoria(&v);
+                break;
+            case 15: demo_listagem_concorrente(); break;
+            case 16: stress_buscas_concorrentes(); break;
+            case 17: skip_inserir(&skip); break;
+            case 18: skip_remover(&skip); break;
+            case 19: skip_listar(&skip); break;
+            case 20: skip_busca(&skip); break;
+            case 21: benchmark_busca_estruturas(); break;
+            case 22: lista_ordenar(&head); break;
+#ifdef MC_DISPONIVEL
+            case 23: vetor_alternar_espelho(&v, &espelho); break;
+#endif
+#ifdef TEM_PTHREAD
+            case 24:
+                if (!v.autosave) { printf("[AUTOSAVE] Desligado.\n"); break; }
+                autosave_salvar_e_esperar(v.autosave);
+                autosave_mostrar(v.autosave);
+                break;
+            case 25: autosave_benchmark(); break;
+#endif
+            case 0: break;
+            default: printf("Opcao invalida.\n");
+        }
+#ifdef MC_DISPONIVEL
+        vetor_espelhar(&v, &espelho);
+#endif
+    } while (opc != 0);
+
+#ifdef MC_DISPONIVEL
+    mc_remover(&espelho);
+#endif
+#ifdef TEM_PTHREAD
+    if (v.autosave) autosave_encerrar(v.autosave); /* grava o que faltou antes de sair */
+#endif
+    vetor_liberar(&v);
+    lista_liberar(&head);
+    bloom_liberar(&filtro_lista);
+    skip_liberar(&skip);
+    hw_fechar();
+}
+
+/* =====================================
+   MÓDULO 3: Torre de Fuga (componentes)
+   - componentes em vetor crescente (sem limite fixo)
+   - bubble por nome, insertion por tipo, selection por prioridade
+   - tipo guardado como id (tipos_item.h): ordenar por tipo compara inteiros
+   - busca binária por nome (após ordenar por nome)
+   - receitas: varios componentes exigidos verificados numa passada
+   ===================================== */
+typedef struct {
+    char nome[TAM_NOME];
+    char tipo[TAM_TIPO];
+    uint32_t tipo_id; /* tipos_item.h: ordenar por tipo compara tipo_ordem(tipo_id) */
+    int prioridade; /* 1..10 */
+    AssinaturaNome assinatura;
+} Componente;
+
+void mod3_mostrar(Componente comps[], size_t n) {
+    separador();
+    printf("Componentes (%zu):\n", n);
     if (n == 0) { printf("Nenhum componente.\n"); return; }
     printf("%-3s | %-28s | %-14s | %-9s\n", "No", "Nome", "Tipo", "Prioridade");
     printf("----+------------------------------+----------------+-----------\n");
-    for (int i = 0; i < n; ++i)
-        printf("%-3d | %-28s | %-14s | %-9d\n", i+1, comps[i].nome, comps[i].tipo, comps[i].prioridade);
+    for (size_t i = 0; i < n; ++i)
+        printf("%-3zu | %-28s | %-14s | %-9d\n", i+1, comps[i].nome, comps[i].tipo, comps[i].prioridade);
 }
 
 /* Troca util */
 void mod3_trocar(Componente *a, Componente *b) { Componente t = *a; *a = *b; *b = t; }
 
 /* Bubble sort por nome */
-long long mod3_bubble_por_nome(Componente comps[], int n, double *tms) {
+long long mod3_bubble_por_nome(Componente comps[], size_t n, double *tms) {
     long long comps_count = 0;
     clock_t t0 = clock();
-    for (int i = 0; i < n - 1; ++i) {
+    for (size_t i = 0; i + 1 < n; ++i) {
         int trocou = 0;
-        for (int j = 0; j < n - 1 - i; ++j) {
+        for (size_t j = 0; j + 1 < n - i; ++j) {
             comps_count++;
             if (strcmp(comps[j].nome, comps[j+1].nome) > 0) {
                 mod3_trocar(&comps[j], &comps[j+1]);
@@ -425,32 +1967,33 @@ long long mod3_bubble_por_nome(Componente comps[], int n, double *tms) {
 }
 
 /* Insertion sort por tipo */
-long long mod3_insertion_por_tipo(Componente comps[], int n, double *tms) {
+long long mod3_insertion_por_tipo(Componente comps[], size_t n, double *tms) {
     long long comps_count = 0;
     clock_t t0 = clock();
-    for (int i = 1; i < n; ++i) {
+    for (size_t i = 1; i < n; ++i) {
         Componente chave = comps[i];
-        int j = i - 1;
-        while (j >= 0) {
+        uint32_t ordem_chave = tipo_ordem(chave.tipo_id);
+        size_t j = i; /* posicao livre */
+        while (j > 0) {
             comps_count++;
-            if (strcmp(comps[j].tipo, chave.tipo) > 0) {
-                comps[j+1] = comps[j];
+            if (tipo_ordem(comps[j-1].tipo_id) > ordem_chave) {
+                comps[j] = comps[j-1];
                 j--;
             } else break;
         }
-        comps[j+1] = chave;
+        comps[j] = chave;
     }
     clock_t t1 = clock(); if (tms) *tms = (double)(t1 - t0)*1000.0/CLOCKS_PER_SEC;
     return comps_count;
 }
 
 /* Selection sort por prioridade (maior->menor) */
-long long mod3_selection_por_prioridade(Componente comps[], int n, double *tms) {
+long long mod3_selection_por_prioridade(Componente comps[], size_t n, double *tms) {
     long long comps_count = 0;
     clock_t t0 = clock();
-    for (int i = 0; i < n - 1; ++i) {
-        int idx_maior = i;
-        for (int j = i + 1; j < n; ++j) {
+    for (size_t i = 0; i + 1 < n; ++i) {
+        size_t idx_maior = i;
+        for (size_t j = i + 1; j < n; ++j) {
             comps_count++;
             if (comps[j].prioridade > comps[idx_maior].prioridade) idx_maior = j;
         }
@@ -460,110 +2003,1602 @@ long long mod3_selection_por_prioridade(Componente comps[], int n, double *tms)
     return comps_count;
 }
 
+/* Criterios de ordenacao do modulo 3 */
+typedef enum { POR_NOME = 1, POR_TIPO, POR_PRIORIDADE } Criterio;
+
+/* Compara dois componentes pelo criterio (prioridade: maior->menor) */
+int mod3_comparar(const Componente *a, const Componente *b, Criterio crit) {
+    if (crit == POR_NOME) return strcmp(a->nome, b->nome);
+    if (crit == POR_TIPO) return (tipo_ordem(a->tipo_id) > tipo_ordem(b->tipo_id)) - (tipo_ordem(a->tipo_id) < tipo_ordem(b->tipo_id));
+    return b->prioridade - a->prioridade;
+}
+
+/* mod3_comparar no formato de selecao_parcial.h (ctx = Criterio*) */
+int mod3_comparar_sp(const void *a, const void *b, void *ctx) {
+    return mod3_comparar(a, b, *(const Criterio *)ctx);
+}
+
+/* Insertion generica por criterio (sai cedo quando o trecho ja esta em ordem);
+   cada deslocamento desfaz exatamente uma inversao, somada em *inversoes */
+long long mod3_insertion_criterio(Componente comps[], size_t n, Criterio crit, long long *inversoes) {
+    long long comps_count = 0;
+    for (size_t i = 1; i < n; ++i) {
+        Componente chave = comps[i];
+        size_t j = i; /* posicao livre */
+        while (j > 0) {
+            comps_count++;
+            if (mod3_comparar(&comps[j-1], &chave, crit) > 0) { comps[j] = comps[j-1]; j--; (*inversoes)++; }
+            else break;
+        }
+        comps[j] = chave;
+    }
+    return comps_count;
+}
+
+/* Intercala [ini, meio) e [meio, fim) de forma estavel usando aux;
+   soma em *inversoes os pares (esquerda, direita) fora de ordem */
+long long mod3_intercalar(Componente comps[], Componente aux[], size_t ini, size_t meio, size_t fim, Criterio crit, long long *inversoes) {
+    long long comps_count = 0;
+    size_t i = ini, j = meio, k = ini;
+    while (i < meio && j < fim) {
+        comps_count++;
+        if (mod3_comparar(&comps[j], &comps[i], crit) < 0) { *inversoes += (long long)(meio - i); aux[k++] = comps[j++]; }
+        else aux[k++] = comps[i++];
+    }
+    while (i < meio) aux[k++] = comps[i++];
+    while (j < fim) aux[k++] = comps[j++];
+    memcpy(&comps[ini], &aux[ini], sizeof(Componente) * (fim - ini));
+    return comps_count;
+}
+
+/* Counting sort estavel por prioridade (1..10, maior->menor): zero comparacoes */
+void mod3_counting_prioridade(Componente comps[], Componente aux[], size_t n) {
+    size_t inicio[12] = {0};
+    for (size_t i = 0; i < n; ++i) inicio[11 - comps[i].prioridade]++;
+    size_t soma = 0;
+    for (int b = 0; b < 12; ++b) { size_t c = inicio[b]; inicio[b] = soma; soma += c; }
+    for (size_t i = 0; i < n; ++i) aux[inicio[11 - comps[i].prioridade]++] = comps[i];
+    memcpy(comps, aux, sizeof(Componente) * n);
+}
+
+/*
+ * Ordenacao adaptativa (estilo TimSort):
+ *  - uma passada mede as runs ja crescentes (n-1 comparacoes, contadas)
+ *  - 0 quebras: nada a fazer; n pequeno: insertion
+ *  - caso contrario: counting sort (prioridade) ou merge natural das runs,
+ *    O(n log runs) mesmo com muitas inversoes (ex.: vetor rotacionado)
+ *  - as inversoes desfeitas sao medidas pela insertion e pelo merge
+ *    (-1 no counting sort, que nao compara)
+ * Inventario re-ordenado apos poucas mudancas tem poucas runs: ~O(n).
+ */
+#define ADAPT_MIN_MERGE 16
+
+long long mod3_ordenar_adaptativo(Componente comps[], size_t n, Criterio crit, double *tms, const char **estrategia, size_t *runs_medidas, long long *inversoes) {
+    long long comps_count = 0;
+    clock_t t0 = clock();
+    *estrategia = "nada a ordenar";
+    *runs_medidas = n ? 1 : 0;
+    *inversoes = 0;
+    if (n >= 2) {
+        size_t *runs = n < SIZE_MAX / sizeof(size_t) ? malloc(sizeof(size_t) * (n + 1)) : NULL;
+        Componente *aux = malloc(sizeof(Componente) * n);
+        size_t nruns = 0;
+        if (runs) {
+            runs[nruns++] = 0;
+            for (size_t i = 1; i < n; ++i) {
+                comps_count++;
+                if (mod3_comparar(&comps[i-1], &comps[i], crit) > 0) runs[nruns++] = i;
+            }
+            runs[nruns] = n;
+        }
+        size_t quebras = nruns ? nruns - 1 : 0;
+        if (runs) *runs_medidas = nruns;
+        if (runs && quebras == 0) {
+            *estrategia = "ja ordenado";
+        } else if (!runs || !aux || n < ADAPT_MIN_MERGE) {
+            *estrategia = "insertion (n pequeno)";
+            comps_count += mod3_insertion_criterio(comps, n, crit, inversoes);
+        } else if (crit == POR_PRIORIDADE) {
+            *estrategia = "counting sort (prioridade)";
+            *inversoes = -1;
+            mod3_counting_prioridade(comps, aux, n);
+        } else {
+            *estrategia = "merge natural das runs";
+            while (nruns > 1) {
+                size_t k = 0;
+                for (size_t r = 0; r < nruns; r += 2) {
+                    if (r + 1 < nruns) comps_count += mod3_intercalar(comps, aux, runs[r], runs[r+1], runs[r+2], crit, inversoes);
+                    runs[k++] = runs[r];
+                }
+                runs[k] = n; nruns = k;
+            }
+        }
+        free(runs); free(aux);
+    }
+    clock_t t1 = clock(); if (tms) *tms = (double)(t1 - t0)*1000.0/CLOCKS_PER_SEC;
+    return comps_count;
+}
+
+/*
+ * Ordenacao multi-chave (ex.: tipo, prioridade desc, nome):
+ *  - cada componente recebe um prefixo de 64 bits com os campos empacotados
+ *    na ordem das chaves (ordem do tipo, prioridade, primeiros bytes do nome),
+ *    invertidos quando a chave e descendente
+ *  - a maioria das comparacoes vira um unico compare de inteiros; so prefixos
+ *    iguais caem no desempate completo pelos campos
+ *  - merge sort estavel sobre os prefixos, depois permuta os componentes
+ */
+#define MULTI_MAX_CHAVES 3
+
+typedef struct {
+    Criterio campo;
+    int descendente;
+} ChaveOrdenacao;
+
+typedef struct {
+    uint64_t prefixo;
+    size_t idx;
+} PrefixoComp;
+
+/* Desempate completo campo a campo (prioridade crescente = 1..10) */
+int mod3_comparar_chaves(const Componente *a, const Componente *b, const ChaveOrdenacao chaves[], int nchaves) {
+    for (int k = 0; k < nchaves; ++k) {
+        int c;
+        if (chaves[k].campo == POR_NOME) c = strcmp(a->nome, b->nome);
+        else if (chaves[k].campo == POR_TIPO) c = (tipo_ordem(a->tipo_id) > tipo_ordem(b->tipo_id)) - (tipo_ordem(a->tipo_id) < tipo_ordem(b->tipo_id));
+        else c = (a->prioridade > b->prioridade) - (a->prioridade < b->prioridade);
+        if (c != 0) return chaves[k].descendente ? -c : c;
+    }
+    return 0;
+}
+
+/* Numero de bits para representar valores 0..maximo */
+int bits_para(uint64_t maximo) {
+    int b = 1;
+    while (b < 64 && (maximo >> b) != 0) b++;
+    return b;
+}
+
+long long mod3_ordenar_multichave(Componente comps[], size_t n, const ChaveOrdenacao chaves[], int nchaves,
+                                  long long *desempates, double *tms) {
+    long long comps_count = 0;
+    *desempates = 0;
+    clock_t t0 = clock();
+    if (n < 2) { if (tms) *tms = 0; return 0; }
+
+    PrefixoComp *pre = malloc(sizeof(PrefixoComp) * n);
+    PrefixoComp *aux = malloc(sizeof(PrefixoComp) * n);
+    Componente *permutados = malloc(sizeof(Componente) * n);
+    if (!pre || !aux || !permutados) { fprintf(stderr, "Memoria insuficiente\n"); exit(1); }
+
+    /* tipo_ordem ja e denso (0..tipos conhecidos-1) e alfabetico */
+    int bits_tipo = bits_para(tipos_quantidade() - 1);
+
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t prefixo = 0;
+        int livres = 64;
+        for (int k = 0; k < nchaves && livres > 0; ++k) {
+            int largura;
+            uint64_t valor;
+            if (chaves[k].campo == POR_TIPO) {
+                largura = bits_tipo; valor = (uint64_t)tipo_ordem(comps[i].tipo_id);
+            } else if (chaves[k].campo == POR_PRIORIDADE) {
+                largura = 4; valor = (uint64_t)comps[i].prioridade;
+            } else {
+                /* nome ocupa os bytes restantes; campos seguintes ficam para o desempate */
+                largura = livres - livres % 8; valor = 0;
+                for (int b = 0; b < largura / 8; ++b) {
+                    unsigned char ch = (unsigned char)comps[i].nome[b];
+                    valor = (valor << 8) | ch;
+                    if (ch == '\0') { valor <<= 8 * (largura / 8 - b - 1); break; }
+                }
+            }
+            if (largura == 0 || largura > livres) break;
+            uint64_t mascara = largura == 64 ? ~(uint64_t)0 : (((uint64_t)1 << largura) - 1);
+            if (chaves[k].descendente) valor = ~valor & mascara;
+            livres -= largura;
+            prefixo |= (valor & mascara) << livres;
+            if (chaves[k].campo == POR_NOME) break;
+        }
+        pre[i].prefixo = prefixo;
+        pre[i].idx = i;
+    }
+
+    /* Merge sort bottom-up estavel sobre os prefixos */
+    for (size_t largura = 1; largura < n; largura *= 2) {
+        for (size_t ini = 0; ini < n; ini += 2 * largura) {
+            size_t meio = largura < n - ini ? ini + largura : n;
+            size_t fim = 2 * largura < n - ini ? ini + 2 * largura : n;
+            size_t i = ini, j = meio, k = ini;
+            while (i < meio && j < fim) {
+                comps_count++;
+                int menor_dir;
+                if (pre[j].prefixo != pre[i].prefixo) menor_dir = pre[j].prefixo < pre[i].prefixo;
+                else {
+                    (*desempates)++;
+                    menor_dir = mod3_comparar_chaves(&comps[pre[j].idx], &comps[pre[i].idx], chaves, nchaves) < 0;
+                }
+                aux[k++] = menor_dir ? pre[j++] : pre[i++];
+            }
+            while (i < meio) aux[k++] = pre[i++];
+            while (j < fim) aux[k++] = pre[j++];
+        }
+        PrefixoComp *t = pre; pre = aux; aux = t;
+    }
+
+    /* Aplica a permutacao */
+    for (size_t i = 0; i < n; ++i) permutados[i] = comps[pre[i].idx];
+    memcpy(comps, permutados, sizeof(Componente) * n);
+
+    free(pre); free(aux); free(permutados);
+    clock_t t1 = clock(); if (tms) *tms = (double)(t1 - t0)*1000.0/CLOCKS_PER_SEC;
+    return comps_count;
+}
+
+/* Le chaves no formato "2 3d 1" (1-nome 2-tipo 3-prioridade, sufixo d = desc) */
+int ler_chaves_ordenacao(ChaveOrdenacao chaves[]) {
+    char linha[64]; ler_linha_trim(linha, sizeof linha);
+    int nchaves = 0;
+    for (char *tok = strtok(linha, " ,"); tok; tok = strtok(NULL, " ,")) {
+        if (nchaves >= MULTI_MAX_CHAVES || tok[0] < '1' || tok[0] > '3') return 0;
+        if (tok[1] != '\0' && !((tok[1] == 'd' || tok[1] == 'D') && tok[2] == '\0')) return 0;
+        chaves[nchaves].campo = (Criterio)(tok[0] - '0');
+        chaves[nchaves].descendente = tok[1] != '\0';
+        nchaves++;
+    }
+    return nchaves;
+}
+
+/* Indice Eytzinger dos componentes (mesmo layout do vetor do modulo 2) */
+typedef struct {
+    char (*nomes)[TAM_NOME]; /* 1-indexado, nomes[0] sem uso */
+    size_t *idx;             /* posicao do nome em comps[] */
+    size_t n;
+    int valido;              /* zerado a cada cadastro ou reordenacao */
+} IndiceEytz3;
+
+/* Reconstroi a partir de comps[] ordenado por nome; 0 = sem memoria */
+int mod3_eytz_construir(IndiceEytz3 *e, const Componente comps[], size_t n) {
+    free(e->nomes); free(e->idx);
+    e->nomes = malloc(sizeof(*e->nomes) * (n + 1));
+    e->idx = malloc(sizeof(size_t) * (n + 1));
+    e->n = 0; e->valido = 0;
+    if (!e->nomes || !e->idx) { free(e->nomes); free(e->idx); e->nomes = NULL; e->idx = NULL; return 0; }
+    if (n) eytz_preencher(e->nomes, e->idx, n, comps[0].nome, sizeof(Componente), 0, 1);
+    e->n = n; e->valido = 1;
+    return 1;
+}
+
 /* Busca binaria por nome (vetor ordenado por nome asc) */
-int mod3_busca_binaria_por_nome(Componente comps[], int n, const char *nome, long long *comparacoes, double *tms) {
+size_t mod3_busca_binaria_por_nome(Componente comps[], size_t n, const char *nome, long long *comparacoes, double *tms) {
     *comparacoes = 0;
-    int l = 0, r = n - 1, idx = -1;
+    size_t l = 0, r = n, idx = VC_NAO_ENCONTRADO; /* intervalo [l, r) */
     clock_t t0 = clock();
-    while (l <= r) {
-        int mid = l + (r - l) / 2;
+    while (l < r) {
+        size_t mid = l + (r - l) / 2;
         (*comparacoes)++;
         int cmp = strcmp(comps[mid].nome, nome);
         if (cmp == 0) { idx = mid; break; }
         else if (cmp < 0) l = mid + 1;
-        else r = mid - 1;
+        else r = mid;
     }
     clock_t t1 = clock();
     if (tms) *tms = (double)(t1 - t0)*1000.0/CLOCKS_PER_SEC;
     return idx;
 }
 
+/* Dobra o filtro do modulo 3 e reinsere os nomes, preservando as estatisticas */
+void mod3_bloom_crescer(FiltroBloom *f, const Componente comps[], size_t n) {
+    FiltroBloom novo;
+    bloom_iniciar_dobro(&novo, f);
+    for (size_t i = 0; i < n; ++i) bloom_adicionar(&novo, comps[i].assinatura.hash);
+    bloom_liberar(f);
+    *f = novo;
+}
+
+/* Presenca do componente-chave numa versao publicada: so leitura, segura em paralelo */
+size_t mod3_presente_versao(const VersaoCow *f, const char *chave, AssinaturaNome ac, long long *comparacoes) {
+    const Componente *c = COW_ITENS(f, Componente);
+    for (size_t i = 0; i < f->tamanho; ++i) {
+        (*comparacoes)++;
+        if (nome_igual_puro(c[i].nome, c[i].assinatura, chave, ac)) return i;
+    }
+    return VC_NAO_ENCONTRADO;
+}
+
+/*
+ * Receitas: um conjunto de componentes exigidos respondido numa passada.
+ *  - nomes viram ids inteiros (internos) uma unica vez, ao cadastrar o
+ *    componente ou compilar a receita
+ *  - o inventario mantem um bitset de ids presentes, unidades por id e a
+ *    maior prioridade por id (atualizados a cada cadastro)
+ *  - verificar uma receita e testar um bit (e, se pedido, ler dois
+ *    vetores) por requisito: sem strcmp e sem varrer o inventario
+ */
+#define INTERNO_AUSENTE UINT32_MAX
+#define INTERNOS_CAPACIDADE_INICIAL 64 /* potencia de 2 */
+
+typedef struct {
+    char nome[TAM_NOME];
+    AssinaturaNome assinatura;
+} NomeInterno;
+
+typedef struct {
+    VetorCrescente nomes; /* id -> NomeInterno */
+    uint32_t *tabela;     /* enderecamento aberto: id + 1, 0 = livre */
+    size_t capacidade;
+} TabelaInternos;
+
+typedef struct {
+    VetorCrescente presentes;  /* bitset de ids (uint64_t) */
+    VetorCrescente unidades;   /* id -> uint32_t: componentes com o nome */
+    VetorCrescente prioridade; /* id -> int: maior prioridade com o nome */
+} IndiceComponentes;
+
+typedef struct {
+    uint32_t id;
+    int minimo;          /* unidades exigidas (>= 1) */
+    int prioridade_min;  /* 0 = qualquer */
+} RequisitoReceita;
+
+void internos_init(TabelaInternos *t) {
+    vc_init(&t->nomes, sizeof(NomeInterno));
+    t->tabela = NULL;
+    t->capacidade = 0;
+}
+
+void internos_liberar(TabelaInternos *t) {
+    vc_liberar(&t->nomes);
+    free(t->tabela);
+    t->tabela = NULL;
+    t->capacidade = 0;
+}
+
+size_t internos_posicao(const TabelaInternos *t, const char *nome, AssinaturaNome a) {
+    const NomeInterno *ns = VC_ITENS(&t->nomes, const NomeInterno);
+    size_t mascara = t->capacidade - 1, i = a.hash & mascara;
+    while (t->tabela[i] && !nome_igual_puro(ns[t->tabela[i] - 1].nome, ns[t->tabela[i] - 1].assinatura, nome, a))
+        i = (i + 1) & mascara;
+    return i;
+}
+
+int internos_crescer(TabelaInternos *t) {
+    size_t nova_cap = t->capacidade ? t->capacidade * 2 : INTERNOS_CAPACIDADE_INICIAL;
+    uint32_t *nova = calloc(nova_cap, sizeof *nova);
+    if (!nova) return 0;
+    free(t->tabela);
+    t->tabela = nova;
+    t->capacidade = nova_cap;
+    const NomeInterno *ns = VC_ITENS(&t->nomes, const NomeInterno);
+    for (size_t id = 0; id < t->nomes.tamanho; ++id)
+        t->tabela[internos_posicao(t, ns[id].nome, ns[id].assinatura)] = (uint32_t)id + 1;
+    return 1;
+}
+
+/* Id do nome; cria se 'criar' (INTERNO_AUSENTE = nao existe ou sem memoria) */
+uint32_t internos_id(TabelaInternos *t, const char *nome, AssinaturaNome a, int criar) {
+    if (criar && (t->nomes.tamanho + 1) * 2 > t->capacidade && !internos_crescer(t)) return INTERNO_AUSENTE;
+    if (t->capacidade == 0) return INTERNO_AUSENTE;
+    size_t i = internos_posicao(t, nome, a);
+    if (t->tabela[i]) return t->tabela[i] - 1;
+    if (!criar || t->nomes.tamanho >= INTERNO_AUSENTE - 1) return INTERNO_AUSENTE;
+    NomeInterno novo;
+    memset(&novo, 0, sizeof novo);
+    snprintf(novo.nome, TAM_NOME, "%s", nome);
+    novo.assinatura = a;
+    if (!vc_inserir(&t->nomes, &novo)) return INTERNO_AUSENTE;
+    t->tabela[i] = (uint32_t)t->nomes.tamanho;
+    return (uint32_t)t->nomes.tamanho - 1;
+}
+
+const char *internos_nome(const TabelaInternos *t, uint32_t id) {
+    return VC_ITENS(&t->nomes, const NomeInterno)[id].nome;
+}
+
+/* Estende o vetor com zeros ate ter n elementos; 0 = sem memoria */
+int vc_estender_zerado(VetorCrescente *v, size_t n) {
+    if (n <= v->tamanho) return 1;
+    if (!vc_garantir(v, n)) return 0;
+    memset((char *)v->dados + v->tamanho * v->tam_elem, 0, (n - v->tamanho) * v->tam_elem);
+    v->tamanho = n;
+    return 1;
+}
+
+void indice_init(IndiceComponentes *ind) {
+    vc_init(&ind->presentes, sizeof(uint64_t));
+    vc_init(&ind->unidades, sizeof(uint32_t));
+    vc_init(&ind->prioridade, sizeof(int));
+}
+
+void indice_liberar(IndiceComponentes *ind) {
+    vc_liberar(&ind->presentes);
+    vc_liberar(&ind->unidades);
+    vc_liberar(&ind->prioridade);
+}
+
+/* Registra um componente cadastrado; 0 = sem memoria */
+int indice_adicionar(IndiceComponentes *ind, uint32_t id, int prioridade) {
+    if (!vc_estender_zerado(&ind->presentes, id / 64 + 1) || !vc_estender_zerado(&ind->unidades, (size_t)id + 1) ||
+        !vc_estender_zerado(&ind->prioridade, (size_t)id + 1)) return 0;
+    VC_ITENS(&ind->presentes, uint64_t)[id / 64] |= 1ull << (id % 64);
+    VC_ITENS(&ind->unidades, uint32_t)[id]++;
+    int *p = &VC_ITENS(&ind->prioridade, int)[id];
+    if (prioridade > *p) *p = prioridade;
+    return 1;
+}
+
+/* Indexa o inventario inteiro (usado pelo benchmark); 0 = sem memoria */
+int indice_construir(IndiceComponentes *ind, TabelaInternos *t, const Componente comps[], size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t id = internos_id(t, comps[i].nome, comps[i].assinatura, 1);
+        if (id == INTERNO_AUSENTE || !indice_adicionar(ind, id, comps[i].prioridade)) return 0;
+    }
+    return 1;
+}
+
+/*
+ * Verifica todos os requisitos numa passada. 'faltando' recebe as posicoes
+ * (em req[]) dos que nao foram atendidos; devolve quantos sao.
+ */
+size_t receita_verificar(const IndiceComponentes *ind, const RequisitoReceita req[], size_t nreq, size_t faltando[]) {
+    const uint64_t *bits = VC_ITENS(&ind->presentes, const uint64_t);
+    const uint32_t *unidades = VC_ITENS(&ind->unidades, const uint32_t);
+    const int *prioridade = VC_ITENS(&ind->prioridade, const int);
+    size_t nids = ind->presentes.tamanho * 64, nfaltando = 0;
+    for (size_t i = 0; i < nreq; ++i) {
+        uint32_t id = req[i].id;
+        int ok = id < nids && (bits[id / 64] >> (id % 64) & 1);
+        if (ok && req[i].minimo > 1) ok = unidades[id] >= (uint32_t)req[i].minimo;
+        if (ok && req[i].prioridade_min > 0) ok = prioridade[id] >= req[i].prioridade_min;
+        if (!ok) faltando[nfaltando++] = i;
+    }
+    return nfaltando;
+}
+
+/*
+ * Nome de uma linha de receita como o cadastro o guardaria: sem espacos em
+ * volta ("Kit ; 2") e cortado em TAM_NOME - 1 bytes, senao o id nao bate.
+ */
+char *receita_nome(char *s) {
+    while (*s == ' ' || *s == '\t') s++;
+    size_t n = strlen(s);
+    while (n > 0 && (s[n - 1] == ' ' || s[n - 1] == '\t' || s[n - 1] == '\r')) n--;
+    if (n > TAM_NOME - 1) n = TAM_NOME - 1;
+    s[n] = '\0';
+    return s;
+}
+
+/* Le "nome[;minimo[;prioridade minima]]" por linha ate uma linha vazia e verifica */
+void mod3_receita(TabelaInternos *t, const IndiceComponentes *ind) {
+    VetorCrescente req; vc_init(&req, sizeof(RequisitoReceita));
+    printf("Componentes da receita, um por linha: nome[;minimo[;prioridade minima]] (linha vazia encerra)\n");
+    char linha[TAM_NOME + 32];
+    for (;;) {
+        printf("> ");
+        if (!entrada_ler_linha(linha, (int)sizeof linha) || linha[0] == '\0') break;
+        RequisitoReceita r = { 0, 1, 0 };
+        char *sep = strchr(linha, ';');
+        if (sep) {
+            *sep++ = '\0';
+            r.minimo = atoi(sep);
+            char *sep2 = strchr(sep, ';');
+            if (sep2) r.prioridade_min = atoi(sep2 + 1);
+            if (r.minimo < 1) r.minimo = 1;
+        }
+        char *nome = receita_nome(linha);
+        if (nome[0] == '\0') { printf("Linha sem nome ignorada.\n"); continue; }
+        /* nomes fora do inventario tambem ganham id: a receita compilada vale para cadastros futuros */
+        r.id = internos_id(t, nome, assinar_nome(nome), 1);
+        if (r.id == INTERNO_AUSENTE || !vc_inserir(&req, &r)) { printf("Memoria insuficiente.\n"); vc_liberar(&req); return; }
+    }
+    if (req.tamanho == 0) { printf("Receita vazia.\n"); vc_liberar(&req); return; }
+    size_t *faltando = malloc(sizeof(size_t) * req.tamanho);
+    if (!faltando) { printf("Memoria insuficiente.\n"); vc_liberar(&req); return; }
+    const RequisitoReceita *r = VC_ITENS(&req, const RequisitoReceita);
+    double t0 = agora_s();
+    size_t nf = receita_verificar(ind, r, req.tamanho, faltando);
+    double us = (agora_s() - t0) * 1e6;
+    if (nf == 0) printf("Receita completa: %zu requisitos atendidos. Tempo: %.3f us\n", req.tamanho, us);
+    else {
+        printf("Faltam %zu de %zu requisitos (Tempo: %.3f us):\n", nf, req.tamanho, us);
+        const uint32_t *unidades = VC_ITENS(&ind->unidades, const uint32_t);
+        const int *prioridade = VC_ITENS(&ind->prioridade, const int);
+        for (size_t k = 0; k < nf; ++k) {
+            const RequisitoReceita *x = &r[faltando[k]];
+            int tem = x->id < ind->unidades.tamanho && unidades[x->id] > 0;
+            printf("  %s: precisa %d (prioridade >= %d), tem %u (maior prioridade %d)\n", internos_nome(t, x->id),
+                   x->minimo, x->prioridade_min, tem ? unidades[x->id] : 0u, tem ? prioridade[x->id] : 0);
+        }
+    }
+    free(faltando);
+    vc_liberar(&req);
+}
+
+/*
+ * Benchmark: RECEITAS_BENCH receitas de RECEITA_BENCH_REQ requisitos contra
+ * um inventario de n componentes. Varredura por nome (como a opcao 7, um nome
+ * por vez) x ids internos + bitset, com os mesmos faltantes nas duas.
+ */
+#define RECEITAS_BENCH 500
+#define RECEITA_BENCH_REQ 8
+#define RECEITA_BENCH_TICKS 100
+
+void mod3_benchmark_receitas() {
+    printf("Componentes no inventario (ex: 5000): ");
+    size_t n; if (entrada_ler_size(&n) != 1 || n == 0) { limpar_buffer(); printf("Entrada invalida.\n"); return; }
+    limpar_buffer();
+    Componente *comps = n <= SIZE_MAX / sizeof(Componente) ? malloc(sizeof(Componente) * n) : NULL;
+    RequisitoReceita *req = malloc(sizeof(RequisitoReceita) * RECEITAS_BENCH * RECEITA_BENCH_REQ);
+    char (*nomes_req)[TAM_NOME] = malloc(sizeof(*nomes_req) * RECEITAS_BENCH * RECEITA_BENCH_REQ);
+    size_t faltando[RECEITA_BENCH_REQ];
+    if (!comps || !req || !nomes_req) { printf("Memoria insuficiente.\n"); free(comps); free(req); free(nomes_req); return; }
+    uint32_t x = 2463534242u, estrutura = tipo_id("Estrutura");
+    for (size_t i = 0; i < n; ++i) {
+        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+        snprintf(comps[i].nome, TAM_NOME, "Peca %zu", (size_t)(x % (n / 2 + 1))); /* nomes repetidos: unidades > 1 */
+        snprintf(comps[i].tipo, TAM_TIPO, "Estrutura");
+        comps[i].tipo_id = estrutura;
+        comps[i].prioridade = (int)(x >> 8) % 10 + 1;
+        comps[i].assinatura = assinar_nome(comps[i].nome);
+    }
+    for (size_t k = 0; k < RECEITAS_BENCH * RECEITA_BENCH_REQ; ++k) {
+        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+        snprintf(nomes_req[k], TAM_NOME, "Peca %zu", (size_t)(x % (n / 2 + n / 8 + 1))); /* parte ausente */
+        req[k].minimo = (int)(x >> 12) % 2 + 1;
+        req[k].prioridade_min = (int)(x >> 16) % 4;
+    }
+
+    /* Varredura: cada requisito percorre o inventario contando unidades */
+    long long faltas_varredura = 0, comparacoes = 0;
+    double t0 = agora_s();
+    for (size_t k = 0; k < RECEITAS_BENCH * RECEITA_BENCH_REQ; ++k) {
+        AssinaturaNome a = assinar_nome(nomes_req[k]);
+        int unidades = 0, maior = 0;
+        for (size_t i = 0; i < n; ++i) {
+            comparacoes++;
+            if (nome_igual_puro(comps[i].nome, comps[i].assinatura, nomes_req[k], a)) {
+                unidades++;
+                if (comps[i].prioridade > maior) maior = comps[i].prioridade;
+            }
+        }
+        if (unidades == 0 || unidades < req[k].minimo || maior < req[k].prioridade_min) faltas_varredura++;
+    }
+    double ms_varredura = (agora_s() - t0) * 1000.0;
+
+    /* Internos: indexa uma vez, compila as receitas uma vez, verifica a cada tick */
+    TabelaInternos t; internos_init(&t);
+    IndiceComponentes ind; indice_init(&ind);
+    t0 = agora_s();
+    int ok = indice_construir(&ind, &t, comps, n);
+    for (size_t k = 0; ok && k < RECEITAS_BENCH * RECEITA_BENCH_REQ; ++k)
+        ok = (req[k].id = internos_id(&t, nomes_req[k], assinar_nome(nomes_req[k]), 1)) != INTERNO_AUSENTE;
+    double ms_preparo = (agora_s() - t0) * 1000.0;
+    if (!ok) printf("Memoria insuficiente.\n");
+    else {
+        long long faltas_indice = 0;
+        t0 = agora_s();
+        for (int tick = 0; tick < RECEITA_BENCH_TICKS; ++tick)
+            for (size_t r = 0; r < RECEITAS_BENCH; ++r) {
+                size_t nf = receita_verificar(&ind, &req[r * RECEITA_BENCH_REQ], RECEITA_BENCH_REQ, faltando);
+                if (tick == 0) faltas_indice += (long long)nf;
+            }
+        double ms_tick = (agora_s() - t0) * 1000.0 / RECEITA_BENCH_TICKS;
+        printf("[RECEITAS] %zu componentes (%zu nomes internos), %d receitas x %d requisitos\n",
+               n, t.nomes.tamanho, RECEITAS_BENCH, RECEITA_BENCH_REQ);
+        printf("[RECEITAS] Varredura por nome: %10.3f ms por tick | comparacoes: %lld | faltantes: %lld\n",
+               ms_varredura, comparacoes, faltas_varredura);
+        printf("[RECEITAS] Ids + bitset:       %10.3f ms por tick | preparo unico %.3f ms | faltantes: %lld\n",
+               ms_tick, ms_preparo, faltas_indice);
+    }
+    indice_liberar(&ind);
+    internos_liberar(&t);
+    free(comps); free(req); free(nomes_req);
+}
+
 void modulo3() {
-    Componente comps[MOD3_MAX];
-    int n = 0;
+    VetorCrescente vcomps; vc_init(&vcomps, sizeof(Componente));
     int ordenado_por_nome = 0;
+    FiltroBloom filtro; bloom_init(&filtro, BLOOM_CONTADORES_INICIAL);
+    CanalCow publicados; cow_init(&publicados); /* versao lida pela confirmacao (opcao 7) */
+    int publicar_pendente = 1;
+    IndiceEytz3 eytz = { NULL, NULL, 0, 0 }; /* busca por nome para muitas leituras (opcao 14) */
+    TabelaInternos internos; internos_init(&internos); /* nomes -> ids das receitas */
+    IndiceComponentes indice; indice_init(&indice);
 
     int opc;
     do {
         separador();
-        printf("MÓDULO 3 - Torre de Fuga (componentes, max %d)\n", MOD3_MAX);
+        printf("MÓDULO 3 - Torre de Fuga (componentes: %zu)\n", vcomps.tamanho);
         printf("1- Cadastrar  2- Listar  3- Bubble por NOME  4- Insertion por TIPO\n");
         printf("5- Selection por PRIORIDADE  6- Busca binaria por NOME  7- Confirmar componente-chave\n");
+        printf("8- Ordenacao adaptativa (escolhe o algoritmo)  9- Ordenacao multi-chave\n");
+        printf("10- Verificar receita (varios componentes de uma vez)  11- Benchmark de receitas\n");
+        printf("12- Top N por criterio (ordenacao parcial)  13- N-esimo por criterio (selecao)\n");
+        printf("14- Busca pelo indice Eytzinger por NOME\n");
         printf("0- Voltar\nEscolha: ");
-        if (scanf("%d", &opc) != 1) { limpar_buffer(); opc = -1; }
+        { int r = entrada_ler_int(&opc); if (r != 1) opc = (r == EOF) ? 0 : -1; }
         limpar_buffer();
+        Componente *comps = VC_ITENS(&vcomps, Componente); /* revalidado a cada volta (o vetor pode crescer) */
+        size_t n = vcomps.tamanho;
         if (opc == 1) {
-            if (n >= MOD3_MAX) { printf("Capacidade atingida. Remova antes.\n"); continue; }
             Componente c;
             printf("Nome: "); ler_linha_trim(c.nome, TAM_NOME);
             printf("Tipo: "); ler_linha_trim(c.tipo, TAM_TIPO);
+            c.tipo_id = tipo_id(c.tipo);
             printf("Prioridade (1..10): ");
-            int p; if (scanf("%d", &p) != 1) { limpar_buffer(); printf("Entrada invalida.\n"); continue; }
+            int p; if (entrada_ler_int(&p) != 1) { limpar_buffer(); printf("Entrada invalida.\n"); continue; }
             limpar_buffer(); if (p < 1) p = 1; if (p > 10) p = 10;
             c.prioridade = p;
-            comps[n++] = c;
-            ordenado_por_nome = 0;
+            c.assinatura = assinar_nome(c.nome);
+            uint32_t id = internos_id(&internos, c.nome, c.assinatura, 1);
+            if (c.tipo_id == TIPO_SEM_MEMORIA || id == INTERNO_AUSENTE || !indice_adicionar(&indice, id, c.prioridade) || !vc_inserir(&vcomps, &c)) {
+                printf("Memoria insuficiente.\n"); continue;
+            }
+            comps = VC_ITENS(&vcomps, Componente); n = vcomps.tamanho;
+            bloom_adicionar(&filtro, c.assinatura.hash);
+            if (bloom_precisa_crescer(&filtro)) mod3_bloom_crescer(&filtro, comps, n);
+            ordenado_por_nome = 0; publicar_pendente = 1; eytz.valido = 0;
             printf("Componente cadastrado.\n");
             mod3_mostrar(comps, n);
         } else if (opc == 2) mod3_mostrar(comps, n);
         else if (opc == 3) {
             double tm = 0; long long comps_count = mod3_bubble_por_nome(comps, n, &tm);
-            ordenado_por_nome = 1;
+            ordenado_por_nome = 1; publicar_pendente = 1; eytz.valido = 0;
             printf("[Bubble por NOME] Comparacoes: %lld | Tempo: %.3f ms\n", comps_count, tm);
             mod3_mostrar(comps, n);
         } else if (opc == 4) {
             double tm = 0; long long comps_count = mod3_insertion_por_tipo(comps, n, &tm);
-            ordenado_por_nome = 0;
+            ordenado_por_nome = 0; publicar_pendente = 1; eytz.valido = 0;
             printf("[Insertion por TIPO] Comparacoes: %lld | Tempo: %.3f ms\n", comps_count, tm);
             mod3_mostrar(comps, n);
         } else if (opc == 5) {
             double tm = 0; long long comps_count = mod3_selection_por_prioridade(comps, n, &tm);
-            ordenado_por_nome = 0;
+            ordenado_por_nome = 0; publicar_pendente = 1; eytz.valido = 0;
             printf("[Selection por PRIORIDADE] Comparacoes: %lld | Tempo: %.3f ms\n", comps_count, tm);
             mod3_mostrar(comps, n);
-        } else if (opc == 6) {
+        } else if (opc == 6 || opc == 14) {
             if (!ordenado_por_nome) {
                 printf("Vetor precisa estar ordenado por NOME para busca binaria. Ordenar agora? (s/n): ");
                 char r[4]; ler_linha_trim(r, 4);
-                if (r[0] == 's' || r[0] == 'S') { double tm=0; mod3_bubble_por_nome(comps, n, &tm); ordenado_por_nome = 1; printf("[Ordenado automaticamente] Tempo: %.3f ms\n", tm); }
+                if (r[0] == 's' || r[0] == 'S') { double tm=0; mod3_bubble_por_nome(comps, n, &tm); ordenado_por_nome = 1; publicar_pendente = 1; eytz.valido = 0; printf("[Ordenado automaticamente] Tempo: %.3f ms\n", tm); }
                 else { printf("Busca binaria cancelada.\n"); continue; }
             }
-            char chave[TAM_NOME]; printf("Nome do componente para buscar (binaria): "); ler_linha_trim(chave, TAM_NOME);
+            if (opc == 14 && !eytz.valido) {
+                clock_t t0 = clock();
+                if (!mod3_eytz_construir(&eytz, comps, n)) { printf("Memoria insuficiente.\n"); continue; }
+                printf("Indice Eytzinger reconstruido (%zu nomes). Tempo: %.3f ms\n", n, (double)(clock() - t0) * 1000.0 / CLOCKS_PER_SEC);
+            }
+            char chave[TAM_NOME]; printf(opc == 6 ? "Nome do componente para buscar (binaria): " : "Nome do componente para buscar (indice): "); ler_linha_trim(chave, TAM_NOME);
             long long comps_count=0; double tm=0;
-            int idx = mod3_busca_binaria_por_nome(comps, n, chave, &comps_count, &tm);
-            if (idx == -1) printf("NAO encontrado. Comparacoes: %lld | Tempo: %.3f ms\n", comps_count, tm);
-            else { printf("Encontrado idx %d. Comparacoes: %lld | Tempo: %.3f ms\n", idx, comps_count, tm); printf("Detalhe: Nome:%s Tipo:%s Prioridade:%d\n", comps[idx].nome, comps[idx].tipo, comps[idx].prioridade); }
+            size_t idx;
+            if (opc == 6) idx = mod3_busca_binaria_por_nome(comps, n, chave, &comps_count, &tm);
+            else {
+                clock_t t0 = clock();
+                idx = eytz_buscar(eytz.nomes, eytz.idx, eytz.n, chave, &comps_count);
+                tm = (double)(clock() - t0) * 1000.0 / CLOCKS_PER_SEC;
+            }
+            if (idx == VC_NAO_ENCONTRADO) printf("NAO encontrado. Comparacoes: %lld | Tempo: %.3f ms\n", comps_count, tm);
+            else { printf("Encontrado idx %zu. Comparacoes: %lld | Tempo: %.3f ms\n", idx, comps_count, tm); printf("Detalhe: Nome:%s Tipo:%s Prioridade:%d\n", comps[idx].nome, comps[idx].tipo, comps[idx].prioridade); }
         } else if (opc == 7) {
             if (n == 0) { printf("Nenhum componente cadastrado.\n"); continue; }
             char chave[TAM_NOME]; printf("Nome do componente-chave: "); ler_linha_trim(chave, TAM_NOME);
-            long long comps_count = 0; clock_t t0 = clock(); int found = -1;
-            for (int i = 0; i < n; ++i) { comps_count++; if (strcmp(comps[i].nome, chave) == 0) { found = i; break; } }
+            long long comps_count = 0; clock_t t0 = clock(); size_t found = VC_NAO_ENCONTRADO;
+            AssinaturaNome ac = assinar_nome(chave);
+            int talvez = bloom_talvez_contem(&filtro, ac.hash);
+            if (talvez) {
+                if (publicar_pendente && cow_publicar(&publicados, comps, n, sizeof(Componente))) publicar_pendente = 0;
+                int leitor = cow_leitor_entrar(&publicados);
+                const VersaoCow *f = leitor >= 0 ? cow_ler(&publicados, leitor) : NULL;
+                found = f ? mod3_presente_versao(f, chave, ac, &comps_count) : VC_NAO_ENCONTRADO;
+                if (leitor >= 0) { cow_soltar(&publicados, leitor); cow_leitor_sair(&publicados, leitor); }
+                if (found == VC_NAO_ENCONTRADO) bloom_registrar_falso_positivo(&filtro);
+            }
             clock_t t1 = clock(); double tm = (double)(t1 - t0) * 1000.0 / CLOCKS_PER_SEC;
-            if (found == -1) printf("Componente-chave NAO presente. Comparacoes: %lld | Tempo: %.3f ms\n", comps_count, tm);
-            else printf("Componente-chave presente idx %d. Comparacoes: %lld | Tempo: %.3f ms\n", found, comps_count, tm);
-        } else if (opc == 0) break;
+            if (found == VC_NAO_ENCONTRADO) printf("Componente-chave NAO presente%s. Comparacoes: %lld | Tempo: %.3f ms\n", talvez ? "" : " (filtro de Bloom)", comps_count, tm);
+            else printf("Componente-chave presente idx %zu. Comparacoes: %lld | Tempo: %.3f ms\n", found, comps_count, tm);
+            bloom_mostrar(&filtro, "componentes");
+        } else if (opc == 8) {
+            printf("Criterio: 1- Nome  2- Tipo  3- Prioridade: ");
+            int crit; if (entrada_ler_int(&crit) != 1) { limpar_buffer(); printf("Entrada invalida.\n"); continue; }
+            limpar_buffer();
+            if (crit < POR_NOME || crit > POR_PRIORIDADE) { printf("Criterio invalido.\n"); continue; }
+            double tm = 0; const char *estrategia; size_t runs_medidas; long long inversoes;
+            long long comps_count = mod3_ordenar_adaptativo(comps, n, crit, &tm, &estrategia, &runs_medidas, &inversoes);
+            ordenado_por_nome = (crit == POR_NOME); publicar_pendente = 1; eytz.valido = 0;
+            printf("[Adaptativa] Estrategia: %s | Runs: %zu", estrategia, runs_medidas);
+            if (inversoes >= 0) printf(" | Inversoes: %lld", inversoes);
+            printf(" | Comparacoes: %lld | Tempo: %.3f ms\n", comps_count, tm);
+            mod3_mostrar(comps, n);
+        } else if (opc == 9) {
+            printf("Chaves em ordem (1- Nome 2- Tipo 3- Prioridade, sufixo d = desc; ex: 2 3d 1): ");
+            ChaveOrdenacao chaves[MULTI_MAX_CHAVES];
+            int nchaves = ler_chaves_ordenacao(chaves);
+            if (nchaves == 0) { printf("Chaves invalidas.\n"); continue; }
+            double tm = 0; long long desempates = 0;
+            long long comps_count = mod3_ordenar_multichave(comps, n, chaves, nchaves, &desempates, &tm);
+            ordenado_por_nome = (chaves[0].campo == POR_NOME && !chaves[0].descendente); publicar_pendente = 1; eytz.valido = 0;
+            printf("[Multi-chave] Comparacoes: %lld (desempates: %lld) | Tempo: %.3f ms\n", comps_count, desempates, tm);
+            mod3_mostrar(comps, n);
+        } else if (opc == 10) mod3_receita(&internos, &indice);
+        else if (opc == 11) mod3_benchmark_receitas();
+        else if (opc == 12 || opc == 13) {
+            if (n == 0) { printf("Nenhum componente cadastrado.\n"); continue; }
+            printf("Criterio: 1- Nome  2- Tipo  3- Prioridade: ");
+            int crit; if (entrada_ler_int(&crit) != 1) { limpar_buffer(); printf("Entrada invalida.\n"); continue; }
+            printf(opc == 12 ? "Quantos primeiros (N): " : "Posicao (N, 1 = primeiro): ");
+            size_t k; if (entrada_ler_size(&k) != 1) { limpar_buffer(); printf("Entrada invalida.\n"); continue; }
+            limpar_buffer();
+            if (crit < POR_NOME || crit > POR_PRIORIDADE) { printf("Criterio invalido.\n"); continue; }
+            if (k == 0 || (opc == 13 && k > n)) { printf("N fora do intervalo (1..%zu).\n", n); continue; }
+            if (k > n) k = n;
+            Criterio c = (Criterio)crit;
+            long long comps_count = 0; clock_t t0 = clock();
+            /* reordena o vetor no lugar: a ordem por nome so sobra se tudo foi ordenado por nome */
+            if (opc == 12) sp_ordenar_parcial(comps, n, sizeof(Componente), k, mod3_comparar_sp, &c, &comps_count);
+            else sp_selecionar(comps, n, sizeof(Componente), k - 1, mod3_comparar_sp, &c, &comps_count);
+            double tm = (double)(clock() - t0) * 1000.0 / CLOCKS_PER_SEC;
+            ordenado_por_nome = (opc == 12 && k == n && c == POR_NOME); publicar_pendente = 1; eytz.valido = 0;
+            if (opc == 12) {
+                printf("[Top %zu de %zu] Comparacoes: %lld | Tempo: %.3f ms\n", k, n, comps_count, tm);
+                mod3_mostrar(comps, k);
+            } else {
+                printf("[Selecao] %zuo: Nome:%s Tipo:%s Prioridade:%d\n", k, comps[k-1].nome, comps[k-1].tipo, comps[k-1].prioridade);
+                printf("Comparacoes: %lld | Tempo: %.3f ms\n", comps_count, tm);
+            }
+        }
+        else if (opc == 0) break;
         else printf("Opcao invalida.\n");
     } while (1);
+    free(eytz.nomes); free(eytz.idx);
+    indice_liberar(&indice);
+    internos_liberar(&internos);
+    bloom_liberar(&filtro);
+    cow_liberar(&publicados);
+    vc_liberar(&vcomps);
+}
+
+/* =====================================
+   MÓDULO 4: Servidor de mochilas (uma por jogador)
+   - motor_mochilas.h: shards com trava/arena proprias
+   - mesmas operacoes dos outros modulos, por id de jogador
+   - benchmark de vazao com 1..N threads
+   ===================================== */
+#define BENCH_MOTOR_JOGADORES 20000
+#define BENCH_MOTOR_ITENS 8
+#define BENCH_MOTOR_OPS 2000000 /* total por rodada, dividido entre as threads */
+#define BENCH_MOTOR_MAX_THREADS 16
+#define POOL_THREADS_PADRAO 4 /* trabalhadores da busca global */
+
+/* Le o id do jogador; 0 = entrada invalida */
+int mod4_ler_jogador(uint64_t *jogador) {
+    long long id;
+    printf("Id do jogador: ");
+    if (entrada_ler_numero(&id, 0) != 1) { limpar_buffer(); printf("Entrada invalida.\n"); return 0; }
+    limpar_buffer();
+    *jogador = (uint64_t)id;
+    return 1;
+}
+
+void mod4_inserir(MotorMochilas *m) {
+    uint64_t jogador; if (!mod4_ler_jogador(&jogador)) return;
+    ItemMotor it;
+    printf("Nome: "); ler_linha_trim(it.nome, MOTOR_TAM_NOME);
+    printf("Tipo: "); ler_linha_trim(it.tipo, MOTOR_TAM_TIPO);
+    printf("Quantidade: "); if (entrada_ler_int(&it.quantidade) != 1) { limpar_buffer(); printf("Entrada invalida.\n"); return; }
+    printf("Prioridade (1-5): "); if (entrada_ler_int(&it.prioridade) != 1) { limpar_buffer(); printf("Entrada invalida.\n"); return; }
+    limpar_buffer();
+    if (!motor_inserir(m, jogador, &it)) printf("Memoria insuficiente.\n");
+    else printf("Item adicionado a mochila do jogador %llu.\n", (unsigned long long)jogador);
+}
+
+void mod4_remover(MotorMochilas *m) {
+    uint64_t jogador; if (!mod4_ler_jogador(&jogador)) return;
+    char nome[MOTOR_TAM_NOME]; printf("Nome a remover: "); ler_linha_trim(nome, MOTOR_TAM_NOME);
+    printf(motor_remover(m, jogador, nome) ? "Removido.\n" : "Nao encontrado.\n");
+}
+
+void mod4_buscar(MotorMochilas *m) {
+    uint64_t jogador; if (!mod4_ler_jogador(&jogador)) return;
+    char nome[MOTOR_TAM_NOME]; printf("Nome a buscar: "); ler_linha_trim(nome, MOTOR_TAM_NOME);
+    ItemMotor it;
+    if (motor_buscar(m, jogador, nome, &it))
+        printf("Encontrado: %s | Tipo: %s | Qt: %d | Prioridade: %d\n", it.nome, it.tipo, it.quantidade, it.prioridade);
+    else printf("Nao encontrado.\n");
+}
+
+void mod4_ordenar(MotorMochilas *m) {
+    uint64_t jogador; if (!mod4_ler_jogador(&jogador)) return;
+    printf("Criterio (1-Nome 2-Tipo 3-Prioridade): ");
+    int crit; if (entrada_ler_int(&crit) != 1) { limpar_buffer(); printf("Entrada invalida.\n"); return; }
+    limpar_buffer();
+    if (crit < MOTOR_POR_NOME || crit > MOTOR_POR_PRIORIDADE) { printf("Criterio invalido.\n"); return; }
+    printf("Ordenado. Comparacoes: %lld\n", motor_ordenar(m, jogador, (CriterioMotor)crit));
+}
+
+void mod4_listar(MotorMochilas *m) {
+    uint64_t jogador; if (!mod4_ler_jogador(&jogador)) return;
+    VetorCrescente foto; vc_init(&foto, sizeof(ItemMotor));
+    size_t n = motor_listar(m, jogador, NULL, 0);
+    /* a mochila pode crescer entre as chamadas: repete ate a foto caber */
+    while (vc_garantir(&foto, n) && (n = motor_listar(m, jogador, foto.dados, foto.capacidade)) > foto.capacidade) { }
+    if (n > foto.capacidade) { printf("Memoria insuficiente.\n"); vc_liberar(&foto); return; }
+    separador(); printf("[JOGADOR %llu] Itens (%zu)\n", (unsigned long long)jogador, n);
+    if (n == 0) printf("Vazio.\n");
+    const ItemMotor *it = VC_ITENS(&foto, const ItemMotor);
+    for (size_t i = 0; i < n; ++i)
+        printf("%zu) Nome: %s | Tipo: %s | Qt: %d | Prioridade: %d\n", i+1, it[i].nome, it[i].tipo, it[i].quantidade, it[i].prioridade);
+    vc_liberar(&foto);
+}
+
+/* Memoria das mochilas frias contra o que ocupariam como vetores de ItemMotor */
+void mod4_mostrar_frio(const EstatisticasMotor *e) {
+    size_t equivalente = e->itens_frios * sizeof(ItemMotor);
+    printf("Frias: %zu mochilas, %zu itens em %zu B (quentes ocupariam %zu B: economia %.1f%%, %.1f B/item)\n",
+           e->frias, e->itens_frios, e->bytes_frios, equivalente,
+           equivalente ? 100.0 * (1.0 - (double)e->bytes_frios / (double)equivalente) : 0.0,
+           e->itens_frios ? (double)e->bytes_frios / (double)e->itens_frios : 0.0);
+    printf("Quentes: %zu B reservados | tipos no dicionario: %zu | compactadas %zu, descompactadas %zu\n",
+           e->bytes_quentes, e->tipos, e->congeladas, e->descongeladas);
+}
+
+void mod4_estatisticas(MotorMochilas *m) {
+    EstatisticasMotor e = motor_estatisticas(m);
+    printf("Jogadores: %zu | itens: %zu | operacoes: %zu\n", e.jogadores, e.itens, e.operacoes);
+    printf("Shards: %d | jogadores por shard: min %zu, max %zu\n", MOTOR_SHARDS, e.shard_min, e.shard_max);
+    mod4_mostrar_frio(&e);
+}
+
+typedef struct {
+    MotorMochilas *m;
+    uint64_t semente;
+    size_t ops;
+    size_t achados;
+} TrabalhoMotor;
+
+/* 80% buscas, 20% alternancias (remove se existe, senao insere) em jogadores aleatorios */
+void *mod4_trabalhador(void *arg) {
+    TrabalhoMotor *t = arg;
+    uint64_t x = t->semente | 1;
+    ItemMotor it = { "", "bench", 1, 3 };
+    char nome[MOTOR_TAM_NOME];
+    for (size_t k = 0; k < t->ops; ++k) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        uint64_t jogador = x % BENCH_MOTOR_JOGADORES;
+        unsigned op = (unsigned)((x >> 32) % 100);
+        snprintf(nome, sizeof nome, "Item %u", (unsigned)((x >> 40) % BENCH_MOTOR_ITENS));
+        if (op < 80) t->achados += (size_t)motor_buscar(t->m, jogador, nome, NULL);
+        else if (!motor_remover(t->m, jogador, nome)) { memcpy(it.nome, nome, sizeof nome); motor_inserir(t->m, jogador, &it); }
+    }
+    return NULL;
+}
+
+void mod4_benchmark() {
+    MotorMochilas *m = malloc(sizeof *m);
+    if (!m || !motor_init(m)) { printf("Memoria insuficiente.\n"); free(m); return; }
+    ItemMotor it = { "", "bench", 1, 3 };
+    for (uint64_t j = 0; j < BENCH_MOTOR_JOGADORES; ++j)
+        for (int k = 0; k < BENCH_MOTOR_ITENS; ++k) {
+            snprintf(it.nome, sizeof it.nome, "Item %d", k);
+            motor_inserir(m, j, &it);
+        }
+    printf("[MOTOR] %d jogadores x %d itens, %d operacoes por rodada (80%% busca, 20%% remove/insere)\n",
+           BENCH_MOTOR_JOGADORES, BENCH_MOTOR_ITENS, BENCH_MOTOR_OPS);
+#if defined(__linux__) && defined(_SC_NPROCESSORS_ONLN)
+    printf("[MOTOR] Nucleos online: %ld\n", sysconf(_SC_NPROCESSORS_ONLN));
+#endif
+    double base = 0.0;
+    for (int nt = 1; nt <= BENCH_MOTOR_MAX_THREADS; nt *= 2) {
+        TrabalhoMotor trab[BENCH_MOTOR_MAX_THREADS];
+        for (int i = 0; i < nt; ++i) trab[i] = (TrabalhoMotor){ m, 0x9E3779B97F4A7C15ull * (uint64_t)(i + 1), BENCH_MOTOR_OPS / (size_t)nt, 0 };
+        double t0 = agora_s();
+#ifdef TEM_PTHREAD
+        pthread_t th[BENCH_MOTOR_MAX_THREADS];
+        int criadas = 0;
+        for (int i = 0; i < nt; ++i) if (pthread_create(&th[i], NULL, mod4_trabalhador, &trab[i]) == 0) criadas++;
+        for (int i = 0; i < criadas; ++i) pthread_join(th[i], NULL);
+        for (int i = criadas; i < nt; ++i) mod4_trabalhador(&trab[i]); /* sem thread: roda aqui */
+#else
+        for (int i = 0; i < nt; ++i) mod4_trabalhador(&trab[i]);
+#endif
+        double seg = agora_s() - t0;
+        double vazao = (double)BENCH_MOTOR_OPS / seg;
+        if (nt == 1) base = vazao;
+        size_t achados = 0; for (int i = 0; i < nt; ++i) achados += trab[i].achados;
+        printf("[MOTOR] %2d threads: %10.0f ops/s (%.2fx) | %.3f s | buscas com sucesso: %zu\n", nt, vazao, vazao / base, seg, achados);
+    }
+    mod4_estatisticas(m);
+    motor_liberar(m);
+    free(m);
+}
+
+/* ---- Busca global (quais mochilas tem o item X) ---- */
+#define GLOBAL_MOSTRAR 20              /* achados impressos na consulta interativa */
+#define BENCH_GLOBAL_JOGADORES 100000  /* 10^5 mochilas */
+#define BENCH_GLOBAL_RARO 100          /* 1 em cada 100 mochilas tem o item raro */
+
+typedef struct {
+    size_t recebidos;
+    double t0, primeiro; /* segundos ate o primeiro lote chegar */
+    int imprimir;
+} FluxoGlobal;
+
+void mod4_receber_global(const uint64_t jogadores[], const ItemMotor itens[], size_t n, void *ctx) {
+    FluxoGlobal *f = ctx;
+    if (f->recebidos == 0) f->primeiro = agora_s() - f->t0;
+    for (size_t i = 0; i < n && f->imprimir; ++i) {
+        if (f->recebidos + i >= GLOBAL_MOSTRAR) { printf("...\n"); f->imprimir = 0; break; }
+        printf("Jogador %llu: %s | Tipo: %s | Qt: %d\n", (unsigned long long)jogadores[i], itens[i].nome, itens[i].tipo, itens[i].quantidade);
+    }
+    f->recebidos += n;
+}
+
+void mod4_busca_global(MotorMochilas *m, PoolMotor *pool) {
+    char nome[MOTOR_TAM_NOME]; printf("Nome do item: "); ler_linha_trim(nome, MOTOR_TAM_NOME);
+    FluxoGlobal f = { 0, agora_s(), 0.0, 1 };
+    size_t total = motor_buscar_global(m, pool, nome, mod4_receber_global, &f);
+    double ms = (agora_s() - f.t0) * 1000.0;
+    printf("Mochilas com '%s': %zu | Tempo: %.3f ms (%d threads)\n", nome, total, ms, pool->nthreads ? pool->nthreads : 1);
+}
+
+/* Latencia da busca global em 10^5 mochilas: varredura sequencial x pool */
+void mod4_benchmark_global() {
+    MotorMochilas *m = malloc(sizeof *m);
+    if (!m || !motor_init(m)) { printf("Memoria insuficiente.\n"); free(m); return; }
+    ItemMotor it = { "", "bench", 1, 3 };
+    double t0 = agora_s();
+    for (uint64_t j = 0; j < BENCH_GLOBAL_JOGADORES; ++j) {
+        for (int k = 0; k < BENCH_MOTOR_ITENS; ++k) {
+            snprintf(it.nome, sizeof it.nome, "Item %d", k);
+            motor_inserir(m, j, &it);
+        }
+        if (j % BENCH_GLOBAL_RARO == 0) { snprintf(it.nome, sizeof it.nome, "Reliquia"); motor_inserir(m, j, &it); }
+    }
+    EstatisticasMotor e = motor_estatisticas(m);
+    printf("[GLOBAL] %zu mochilas, %zu itens (montadas em %.0f ms)\n", e.jogadores, e.itens, (agora_s() - t0) * 1000.0);
+    static const char *consultas[] = { "Reliquia", "Item 3", "Inexistente" };
+    for (int nt = 0; nt <= 8; nt = nt ? nt * 2 : 1) {
+        PoolMotor pool; motor_pool_init(&pool, nt);
+        for (size_t q = 0; q < sizeof consultas / sizeof consultas[0]; ++q) {
+            FluxoGlobal f = { 0, agora_s(), 0.0, 0 };
+            size_t achados = motor_buscar_global(m, &pool, consultas[q], mod4_receber_global, &f);
+            double ms = (agora_s() - f.t0) * 1000.0;
+            char modo[16];
+            if (pool.nthreads) snprintf(modo, sizeof modo, "pool de %d", pool.nthreads); else snprintf(modo, sizeof modo, "sequencial");
+            printf("[GLOBAL] %-10s | %-11s | achados %7zu | total %8.3f ms | primeiro lote %8.3f ms\n",
+                   modo, consultas[q], achados, ms, achados ? f.primeiro * 1000.0 : 0.0);
+        }
+        motor_pool_liberar(&pool);
+    }
+    motor_liberar(m);
+    free(m);
+}
+
+void mod4_compactar(MotorMochilas *m, PoolMotor *pool) {
+    printf("Compactar mochilas sem uso ha quantas operacoes do shard? (0 = todas, padrao %d): ", MOTOR_IDADE_FRIA);
+    size_t idade; if (entrada_ler_size(&idade) != 1) { limpar_buffer(); printf("Entrada invalida.\n"); return; }
+    limpar_buffer();
+    EstatisticasMotor antes = motor_estatisticas(m);
+    double t0 = agora_s();
+    size_t n = motor_compactar(m, pool, idade);
+    double ms = (agora_s() - t0) * 1000.0;
+    EstatisticasMotor depois = motor_estatisticas(m);
+    printf("Compactadas agora: %zu mochilas em %.3f ms | memoria de itens: %zu B -> %zu B\n", n, ms,
+           antes.bytes_quentes + antes.bytes_frios, depois.bytes_quentes + depois.bytes_frios);
+    mod4_mostrar_frio(&depois);
+}
+
+/*
+ * Armazenamento frio em 10^5 mochilas com nomes e tipos do jogo: memoria
+ * quente x fria, tempo para compactar, busca global sobre as mochilas frias
+ * e custo do primeiro acesso (descompactar).
+ */
+void mod4_benchmark_frio(PoolMotor *pool) {
+    static const char *nomes[] = {
+        "Kit medico", "Kit reparo", "Municao 5.56", "Municao 7.62", "Municao 9mm", "Granada",
+        "Colete nivel 2", "Colete nivel 3", "Capacete nivel 2", "Mochila nivel 3", "Bandagem", "Energetico"
+    };
+    static const char *tipos[] = { "Cura", "Reparo", "Municao", "Municao", "Municao", "Arremessavel",
+                                   "Protecao", "Protecao", "Protecao", "Equipamento", "Cura", "Cura" };
+    const size_t nnomes = sizeof nomes / sizeof nomes[0];
+    MotorMochilas *m = malloc(sizeof *m);
+    if (!m || !motor_init(m)) { printf("Memoria insuficiente.\n"); free(m); return; }
+    uint64_t x = 88172645463325252ull;
+    for (uint64_t j = 0; j < BENCH_GLOBAL_JOGADORES; ++j)
+        for (int k = 0; k < BENCH_MOTOR_ITENS; ++k) {
+            x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+            size_t q = (size_t)(x % nnomes);
+            ItemMotor it;
+            memset(&it, 0, sizeof it);
+            snprintf(it.nome, sizeof it.nome, "%s", nomes[q]);
+            snprintf(it.tipo, sizeof it.tipo, "%s", tipos[q]);
+            it.quantidade = (int)(x >> 40) % 120 + 1;
+            it.prioridade = (int)(x >> 20) % 5 + 1;
+            motor_inserir(m, j, &it);
+        }
+    EstatisticasMotor e = motor_estatisticas(m);
+    printf("[FRIO] %zu mochilas, %zu itens | quentes: %zu B reservados (%zu B exatos)\n",
+           e.jogadores, e.itens, e.bytes_quentes, e.itens * sizeof(ItemMotor));
+    FluxoGlobal f = { 0, agora_s(), 0.0, 0 };
+    size_t achados = motor_buscar_global(m, pool, "Granada", mod4_receber_global, &f);
+    printf("[FRIO] Busca global quente: %zu achados em %.3f ms\n", achados, (agora_s() - f.t0) * 1000.0);
+
+    double t0 = agora_s();
+    size_t n = motor_compactar(m, pool, 0);
+    double ms = (agora_s() - t0) * 1000.0;
+    e = motor_estatisticas(m);
+    printf("[FRIO] Compactadas %zu mochilas em %.3f ms\n", n, ms);
+    mod4_mostrar_frio(&e);
+
+    f.recebidos = 0; f.t0 = agora_s();
+    achados = motor_buscar_global(m, pool, "Granada", mod4_receber_global, &f);
+    printf("[FRIO] Busca global fria (decodifica sem descompactar): %zu achados em %.3f ms\n", achados, (agora_s() - f.t0) * 1000.0);
+
+    /* Primeiro acesso: descompacta; o segundo ja acha a mochila quente */
+    t0 = agora_s();
+    for (uint64_t j = 0; j < BENCH_GLOBAL_JOGADORES; j += 10) motor_buscar(m, j, "Granada", NULL);
+    double ms_frio = (agora_s() - t0) * 1000.0;
+    t0 = agora_s();
+    for (uint64_t j = 0; j < BENCH_GLOBAL_JOGADORES; j += 10) motor_buscar(m, j, "Granada", NULL);
+    double ms_quente = (agora_s() - t0) * 1000.0;
+    printf("[FRIO] %d buscas por jogador: primeiro acesso (descompacta) %.3f ms | segundo acesso %.3f ms\n",
+           BENCH_GLOBAL_JOGADORES / 10, ms_frio, ms_quente);
+    e = motor_estatisticas(m);
+    mod4_mostrar_frio(&e);
+    motor_liberar(m);
+    free(m);
+}
+
+void modulo4() {
+    MotorMochilas *m = malloc(sizeof *m);
+    if (!m || !motor_init(m)) { printf("Memoria insuficiente.\n"); free(m); return; }
+    PoolMotor pool; motor_pool_init(&pool, POOL_THREADS_PADRAO);
+    int opc;
+    do {
+        separador();
+        printf("MÓDULO 4 - Servidor de mochilas (uma por jogador, %d shards)\n", MOTOR_SHARDS);
+        printf("1- Inserir  2- Remover  3- Buscar  4- Ordenar  5- Listar\n");
+        printf("6- Estatisticas  7- Benchmark de vazao (1..%d threads)\n", BENCH_MOTOR_MAX_THREADS);
+        printf("8- Busca global (quais mochilas tem o item)  9- Benchmark da busca global (10^5 mochilas)\n");
+        printf("10- Compactar mochilas ociosas (armazenamento frio)  11- Benchmark do armazenamento frio\n");
+        printf("0- Voltar\nEscolha: ");
+        { int r = entrada_ler_int(&opc); if (r != 1) opc = (r == EOF) ? 0 : -1; }
+        limpar_buffer();
+        switch (opc) {
+            case 1: mod4_inserir(m); break;
+            case 2: mod4_remover(m); break;
+            case 3: mod4_buscar(m); break;
+            case 4: mod4_ordenar(m); break;
+            case 5: mod4_listar(m); break;
+            case 6: mod4_estatisticas(m); break;
+            case 7: mod4_benchmark(); break;
+            case 8: mod4_busca_global(m, &pool); break;
+            case 9: mod4_benchmark_global(); break;
+            case 10: mod4_compactar(m, &pool); break;
+            case 11: mod4_benchmark_frio(&pool); break;
+            case 0: break;
+            default: printf("Opcao invalida.\n");
+        }
+    } while (opc != 0);
+    motor_pool_liberar(&pool);
+    motor_liberar(m);
+    free(m);
+}
+
+/* =====================================
+   SERVIDOR: motor de mochilas num socket Unix (Linux)
+   - ./jogo --servidor [caminho]: laco epoll nao bloqueante, um processo
+     atende varios processos de jogo
+   - ./jogo --carga [caminho] [conexoes] [pedidos] [janela]: gerador de
+     carga com pedidos em pipeline; mede pedidos/s e latencia de cauda
+   - protocolo binario: cabecalho fixo + corpo. Cada conexao pode mandar
+     varios pedidos sem esperar; as respostas saem na mesma ordem,
+     acumuladas num buffer e escritas em lote
+   - quando o laco fica ocioso, compacta as mochilas sem uso recente
+   ===================================== */
+#ifdef __linux__
+#define SRV_CAMINHO_PADRAO "/tmp/mochilas.sock"
+#define SRV_MAX_EVENTOS 64
+#define SRV_MAX_CORPO 4096
+#define SRV_LEITURA 65536          /* bytes lidos por evento */
+#define SRV_LIMITE_SAIDA (1 << 20) /* acima disso para de ler o cliente ate ele consumir */
+#define SRV_MAX_ITENS_LISTA 256
+#define SRV_OCIOSO_MS 1000         /* sem eventos por esse tempo: compacta mochilas ociosas */
+
+enum { OP_INSERIR = 1, OP_REMOVER, OP_BUSCAR, OP_ORDENAR, OP_LISTAR };
+enum { ST_OK = 0, ST_NAO_ENCONTRADO, ST_INVALIDO, ST_SEM_MEMORIA, ST_NSTATUS };
+
+/*
+ * Pedido:   CabecalhoPedido + corpo
+ *   INSERIR: ItemMotor | REMOVER/BUSCAR: nome (sem '\0') | ORDENAR: criterio no cabecalho | LISTAR: vazio
+ * Resposta: CabecalhoResposta + corpo
+ *   BUSCAR: ItemMotor | ORDENAR: int64 comparacoes | LISTAR: n x ItemMotor
+ */
+typedef struct {
+    uint32_t tamanho;  /* bytes do corpo */
+    uint8_t op;
+    uint8_t criterio;
+    uint16_t reservado;
+    uint32_t id;       /* ecoado na resposta */
+    uint32_t reservado2;
+    uint64_t jogador;
+} CabecalhoPedido;
+
+typedef struct {
+    uint32_t tamanho;
+    uint8_t op;
+    uint8_t status;
+    uint16_t reservado;
+    uint32_t id;
+} CabecalhoResposta;
+
+_Static_assert(sizeof(CabecalhoPedido) == 24, "cabecalho de pedido sem padding");
+_Static_assert(sizeof(CabecalhoResposta) == 12, "cabecalho de resposta sem padding");
+
+/* Acrescenta n bytes num VetorCrescente de bytes; 0 = sem memoria */
+int bytes_acrescentar(VetorCrescente *b, const void *dados, size_t n) {
+    if (!vc_garantir(b, b->tamanho + n)) return 0;
+    if (n) memcpy((char *)b->dados + b->tamanho, dados, n);
+    b->tamanho += n;
+    return 1;
+}
+
+/* Descarta os primeiros n bytes */
+void bytes_consumir(VetorCrescente *b, size_t n) {
+    memmove(b->dados, (char *)b->dados + n, b->tamanho - n);
+    b->tamanho -= n;
+}
+
+int socket_unix(const char *caminho, struct sockaddr_un *end) {
+    if (strlen(caminho) >= sizeof end->sun_path) { fprintf(stderr, "Caminho do socket longo demais.\n"); return -1; }
+    memset(end, 0, sizeof *end);
+    end->sun_family = AF_UNIX;
+    strcpy(end->sun_path, caminho);
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) perror("socket");
+    return fd;
+}
+
+typedef struct {
+    int fd;
+    VetorCrescente entrada, saida; /* bytes */
+    size_t enviado;                /* prefixo de saida ja escrito */
+    uint32_t mascara;              /* eventos registrados no epoll */
+} ConexaoSrv;
+
+static volatile sig_atomic_t srv_parar = 0;
+void srv_sinal(int sig) { (void)sig; srv_parar = 1; }
+
+/* Atende um pedido completo e acrescenta a resposta; 0 = sem memoria (fecha a conexao) */
+int srv_atender(MotorMochilas *m, ConexaoSrv *c, const CabecalhoPedido *p, const char *corpo, long long status[]) {
+    CabecalhoResposta r = { 0, p->op, ST_OK, 0, p->id };
+    size_t inicio = c->saida.tamanho;
+    if (!bytes_acrescentar(&c->saida, &r, sizeof r)) return 0;
+    char nome[MOTOR_TAM_NOME];
+    switch (p->op) {
+        case OP_INSERIR: {
+            ItemMotor it;
+            if (p->tamanho != sizeof it) { r.status = ST_INVALIDO; break; }
+            memcpy(&it, corpo, sizeof it);
+            it.nome[MOTOR_TAM_NOME - 1] = '\0';
+            it.tipo[MOTOR_TAM_TIPO - 1] = '\0';
+            if (!motor_inserir(m, p->jogador, &it)) r.status = ST_SEM_MEMORIA;
+            break;
+        }
+        case OP_REMOVER:
+        case OP_BUSCAR: {
+            if (p->tamanho == 0 || p->tamanho >= MOTOR_TAM_NOME) { r.status = ST_INVALIDO; break; }
+            memcpy(nome, corpo, p->tamanho);
+            nome[p->tamanho] = '\0';
+            if (p->op == OP_REMOVER) {
+                if (!motor_remover(m, p->jogador, nome)) r.status = ST_NAO_ENCONTRADO;
+            } else {
+                ItemMotor it;
+                if (!motor_buscar(m, p->jogador, nome, &it)) r.status = ST_NAO_ENCONTRADO;
+                else if (!bytes_acrescentar(&c->saida, &it, sizeof it)) return 0;
+            }
+            break;
+        }
+        case OP_ORDENAR: {
+            if (p->criterio < MOTOR_POR_NOME || p->criterio > MOTOR_POR_PRIORIDADE) { r.status = ST_INVALIDO; break; }
+            int64_t comparacoes = motor_ordenar(m, p->jogador, (CriterioMotor)p->criterio);
+            if (!bytes_acrescentar(&c->saida, &comparacoes, sizeof comparacoes)) return 0;
+            break;
+        }
+        case OP_LISTAR: {
+            size_t n = motor_listar(m, p->jogador, NULL, 0);
+            if (n > SRV_MAX_ITENS_LISTA) n = SRV_MAX_ITENS_LISTA;
+            if (!vc_garantir(&c->saida, c->saida.tamanho + n * sizeof(ItemMotor))) return 0;
+            size_t total = motor_listar(m, p->jogador, (char *)c->saida.dados + c->saida.tamanho, n); /* bytes: sem exigir alinhamento */
+            if (total < n) n = total;
+            c->saida.tamanho += n * sizeof(ItemMotor);
+            break;
+        }
+        default:
+            r.status = ST_INVALIDO;
+    }
+    r.tamanho = (uint32_t)(c->saida.tamanho - inicio - sizeof r);
+    memcpy((char *)c->saida.dados + inicio, &r, sizeof r);
+    status[r.status]++;
+    return 1;
+}
+
+/* Uma leitura + todos os pedidos completos do buffer; 0 = fechar a conexao */
+int srv_ler(MotorMochilas *m, ConexaoSrv *c, long long status[]) {
+    if (!vc_garantir(&c->entrada, c->entrada.tamanho + SRV_LEITURA)) return 0;
+    ssize_t k = read(c->fd, (char *)c->entrada.dados + c->entrada.tamanho, SRV_LEITURA);
+    if (k == 0) return 0;
+    if (k < 0) return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    c->entrada.tamanho += (size_t)k;
+
+    size_t pos = 0;
+    while (c->entrada.tamanho - pos >= sizeof(CabecalhoPedido)) {
+        CabecalhoPedido p;
+        memcpy(&p, (char *)c->entrada.dados + pos, sizeof p);
+        if (p.tamanho > SRV_MAX_CORPO) return 0; /* cliente fora do protocolo */
+        if (c->entrada.tamanho - pos - sizeof p < p.tamanho) break; /* corpo ainda chegando */
+        if (!srv_atender(m, c, &p, (char *)c->entrada.dados + pos + sizeof p, status)) return 0;
+        pos += sizeof p + p.tamanho;
+    }
+    bytes_consumir(&c->entrada, pos);
+    return 1;
+}
+
+/* Escreve o que der da saida acumulada; 0 = erro (fechar) */
+int srv_escrever(ConexaoSrv *c) {
+    while (c->enviado < c->saida.tamanho) {
+        ssize_t k = send(c->fd, (char *)c->saida.dados + c->enviado, c->saida.tamanho - c->enviado, MSG_NOSIGNAL);
+        if (k > 0) { c->enviado += (size_t)k; continue; }
+        if (k < 0 && errno == EINTR) continue;
+        if (k < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        return 0;
+    }
+    if (c->enviado == c->saida.tamanho) c->saida.tamanho = c->enviado = 0;
+    else if (c->enviado > SRV_LIMITE_SAIDA / 2) { bytes_consumir(&c->saida, c->enviado); c->enviado = 0; }
+    return 1;
+}
+
+/* Reajusta os eventos: EPOLLOUT so com saida pendente; para de ler se o cliente nao consome */
+void srv_rearmar(int ep, ConexaoSrv *c) {
+    size_t pendente = c->saida.tamanho - c->enviado;
+    uint32_t mascara = (pendente < SRV_LIMITE_SAIDA ? EPOLLIN : 0) | (pendente ? EPOLLOUT : 0) | EPOLLRDHUP;
+    if (mascara == c->mascara) return;
+    struct epoll_event ev = { .events = mascara, .data.ptr = c };
+    epoll_ctl(ep, EPOLL_CTL_MOD, c->fd, &ev);
+    c->mascara = mascara;
+}
+
+void srv_fechar(int ep, ConexaoSrv *c) {
+    epoll_ctl(ep, EPOLL_CTL_DEL, c->fd, NULL);
+    close(c->fd);
+    vc_liberar(&c->entrada);
+    vc_liberar(&c->saida);
+    free(c);
+}
+
+int servidor_executar(const char *caminho) {
+    struct sockaddr_un end;
+    int escuta = socket_unix(caminho, &end);
+    if (escuta < 0) return 1;
+    unlink(caminho);
+    if (bind(escuta, (struct sockaddr *)&end, sizeof end) < 0 || listen(escuta, 128) < 0) {
+        perror("bind/listen"); close(escuta); return 1;
+    }
+    int ep = epoll_create1(EPOLL_CLOEXEC);
+    struct epoll_event ev = { .events = EPOLLIN, .data.ptr = NULL };
+    if (ep < 0 || epoll_ctl(ep, EPOLL_CTL_ADD, escuta, &ev) < 0) { perror("epoll"); close(escuta); return 1; }
+
+    MotorMochilas *m = malloc(sizeof *m);
+    if (!m || !motor_init(m)) { fprintf(stderr, "Memoria insuficiente.\n"); free(m); close(ep); close(escuta); return 1; }
+    struct sigaction sa;
+    memset(&sa, 0, sizeof sa);
+    sa.sa_handler = srv_sinal; /* sem SA_RESTART: epoll_wait volta com EINTR */
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    printf("[SERVIDOR] Atendendo em %s (Ctrl+C encerra)\n", caminho);
+    fflush(stdout);
+
+    long long status[ST_NSTATUS] = { 0 }, conexoes = 0;
+    size_t compactadas = 0;
+    struct epoll_event eventos[SRV_MAX_EVENTOS];
+    while (!srv_parar) {
+        int n = epoll_wait(ep, eventos, SRV_MAX_EVENTOS, SRV_OCIOSO_MS);
+        if (n < 0) { if (errno == EINTR) continue; perror("epoll_wait"); break; }
+        if (n == 0) { compactadas += motor_compactar(m, NULL, MOTOR_IDADE_FRIA); continue; } /* laco ocioso */
+        for (int i = 0; i < n; ++i) {
+            ConexaoSrv *c = eventos[i].data.ptr;
+            if (!c) { /* novas conexoes */
+                int fd;
+                while ((fd = accept4(escuta, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+                    ConexaoSrv *nc = malloc(sizeof *nc);
+                    if (!nc) { close(fd); continue; }
+                    nc->fd = fd;
+                    vc_init(&nc->entrada, 1);
+                    vc_init(&nc->saida, 1);
+                    nc->enviado = 0;
+                    nc->mascara = EPOLLIN | EPOLLRDHUP;
+                    struct epoll_event cev = { .events = nc->mascara, .data.ptr = nc };
+                    if (epoll_ctl(ep, EPOLL_CTL_ADD, fd, &cev) < 0) { close(fd); free(nc); continue; }
+                    conexoes++;
+                }
+                continue;
+            }
+            uint32_t e = eventos[i].events;
+            int vivo = !(e & EPOLLERR);
+            if (vivo && (e & (EPOLLIN | EPOLLRDHUP | EPOLLHUP))) vivo = srv_ler(m, c, status);
+            if (vivo) vivo = srv_escrever(c); /* respostas do lote inteiro numa escrita */
+            if (!vivo) { srv_fechar(ep, c); continue; }
+            srv_rearmar(ep, c);
+        }
+    }
+    long long total = 0; for (int s = 0; s < ST_NSTATUS; ++s) total += status[s];
+    EstatisticasMotor est = motor_estatisticas(m);
+    printf("\n[SERVIDOR] Encerrado. Conexoes: %lld | pedidos: %lld (ok %lld, nao encontrado %lld, invalido %lld, sem memoria %lld)\n",
+           conexoes, total, status[ST_OK], status[ST_NAO_ENCONTRADO], status[ST_INVALIDO], status[ST_SEM_MEMORIA]);
+    printf("[SERVIDOR] Jogadores: %zu | itens: %zu | compactadas no ocio: %zu (frias agora: %zu, %zu B)\n",
+           est.jogadores, est.itens, compactadas, est.frias, est.bytes_frios);
+    /* conexoes ainda abertas sao fechadas pelo SO na saida */
+    motor_liberar(m);
+    free(m);
+    close(ep);
+    close(escuta);
+    unlink(caminho);
+    return 0;
+}
+
+/* ---------- Gerador de carga ---------- */
+
+#define CARGA_JOGADORES 10000
+#define CARGA_NOMES 16
+
+typedef struct {
+    int fd;
+    VetorCrescente saida, entrada; /* bytes */
+    size_t enviado;
+    double *envio;                 /* horario de envio, fila circular de 'janela' posicoes */
+    size_t cabeca, pendentes;
+    uint32_t proximo_id, esperado_id;
+} ConexaoCarga;
+
+int comparar_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/* Percentil p (0..1) de um vetor ja ordenado */
+double percentil(const double *ordenado, long long n, double p) {
+    return ordenado[(size_t)((double)(n - 1) * p)];
+}
+
+/* Monta um pedido aleatorio: 70% busca, 10% insere, 10% remove, 5% lista, 5% ordena */
+int carga_montar(ConexaoCarga *c, uint64_t *x) {
+    *x ^= *x << 13; *x ^= *x >> 7; *x ^= *x << 17;
+    unsigned sorteio = (unsigned)(*x % 100);
+    CabecalhoPedido p = { 0, 0, 0, 0, c->proximo_id++, 0, (*x >> 8) % CARGA_JOGADORES };
+    char nome[MOTOR_TAM_NOME];
+    int tam = snprintf(nome, sizeof nome, "Item %u", (unsigned)((*x >> 40) % CARGA_NOMES));
+    if (sorteio < 70 || (sorteio >= 80 && sorteio < 90)) {
+        p.op = sorteio < 70 ? OP_BUSCAR : OP_REMOVER;
+        p.tamanho = (uint32_t)tam;
+        return bytes_acrescentar(&c->saida, &p, sizeof p) && bytes_acrescentar(&c->saida, nome, (size_t)tam);
+    }
+    if (sorteio < 80) {
+        ItemMotor it;
+        memset(&it, 0, sizeof it);
+        memcpy(it.nome, nome, (size_t)tam + 1);
+        strcpy(it.tipo, "carga");
+        it.quantidade = 1; it.prioridade = (int)(*x % 5) + 1;
+        p.op = OP_INSERIR;
+        p.tamanho = sizeof it;
+        return bytes_acrescentar(&c->saida, &p, sizeof p) && bytes_acrescentar(&c->saida, &it, sizeof it);
+    }
+    p.op = sorteio < 95 ? OP_LISTAR : OP_ORDENAR;
+    p.criterio = MOTOR_POR_PRIORIDADE;
+    return bytes_acrescentar(&c->saida, &p, sizeof p);
+}
+
+int carga_executar(int argc, char **argv) {
+    const char *caminho = argc > 2 ? argv[2] : SRV_CAMINHO_PADRAO;
+    int nconexoes = argc > 3 ? atoi(argv[3]) : 8;
+    long long total = argc > 4 ? atoll(argv[4]) : 200000;
+    int janela = argc > 5 ? atoi(argv[5]) : 32;
+    if (nconexoes < 1 || total < 1 || janela < 1) { fprintf(stderr, "Uso: --carga [caminho] [conexoes] [pedidos] [janela]\n"); return 1; }
+
+    ConexaoCarga *cs = calloc((size_t)nconexoes, sizeof *cs);
+    double *latencias = malloc(sizeof(double) * (size_t)total);
+    int ep = epoll_create1(EPOLL_CLOEXEC);
+    if (!cs || !latencias || ep < 0) { fprintf(stderr, "Memoria insuficiente.\n"); free(cs); free(latencias); return 1; }
+    int abertas = 0;
+    for (int i = 0; i < nconexoes; ++i) {
+        struct sockaddr_un end;
+        ConexaoCarga *c = &cs[i];
+        c->fd = socket_unix(caminho, &end);
+        c->envio = malloc(sizeof(double) * (size_t)janela);
+        vc_init(&c->saida, 1);
+        vc_init(&c->entrada, 1);
+        if (c->fd < 0 || !c->envio) break;
+        /* connect em socket Unix nao bloqueante conclui na hora ou falha */
+        if (connect(c->fd, (struct sockaddr *)&end, sizeof end) < 0) { perror("connect"); close(c->fd); c->fd = -1; break; }
+        struct epoll_event ev = { .events = EPOLLIN | EPOLLOUT, .data.ptr = c };
+        epoll_ctl(ep, EPOLL_CTL_ADD, c->fd, &ev);
+        abertas++;
+    }
+    if (abertas < nconexoes) { fprintf(stderr, "[CARGA] Servidor indisponivel em %s\n", caminho); total = 0; }
+
+    uint64_t x = 0x9E3779B97F4A7C15ull;
+    long long emitidos = 0, recebidos = 0, status[ST_NSTATUS] = { 0 }, fora_de_ordem = 0;
+    struct epoll_event eventos[SRV_MAX_EVENTOS];
+    double t0 = agora_s();
+    while (recebidos < total) {
+        int n = epoll_wait(ep, eventos, SRV_MAX_EVENTOS, 1000);
+        if (n < 0) { if (errno == EINTR) continue; perror("epoll_wait"); break; }
+        if (n == 0) { fprintf(stderr, "[CARGA] Sem resposta do servidor.\n"); break; }
+        int erro = 0;
+        for (int i = 0; i < n && !erro; ++i) {
+            ConexaoCarga *c = eventos[i].data.ptr;
+            if (eventos[i].events & (EPOLLERR | EPOLLHUP)) { erro = 1; break; }
+            if (eventos[i].events & EPOLLIN) {
+                if (!vc_garantir(&c->entrada, c->entrada.tamanho + SRV_LEITURA)) { erro = 1; break; }
+                ssize_t k = read(c->fd, (char *)c->entrada.dados + c->entrada.tamanho, SRV_LEITURA);
+                if (k == 0 || (k < 0 && errno != EAGAIN && errno != EINTR)) { erro = 1; break; }
+                if (k > 0) c->entrada.tamanho += (size_t)k;
+                double agora = agora_s();
+                size_t pos = 0;
+                while (c->entrada.tamanho - pos >= sizeof(CabecalhoResposta)) {
+                    CabecalhoResposta r;
+                    memcpy(&r, (char *)c->entrada.dados + pos, sizeof r);
+                    if (c->entrada.tamanho - pos - sizeof r < r.tamanho) break;
+                    if (r.id != c->esperado_id) fora_de_ordem++;
+                    c->esperado_id = r.id + 1;
+                    if (r.status < ST_NSTATUS) status[r.status]++;
+                    latencias[recebidos++] = (agora - c->envio[c->cabeca]) * 1e6;
+                    c->cabeca = (c->cabeca + 1) % (size_t)janela;
+                    c->pendentes--;
+                    pos += sizeof r + r.tamanho;
+                }
+                bytes_consumir(&c->entrada, pos);
+            }
+            /* completa a janela: varios pedidos por escrita (pipeline) */
+            double agora = agora_s();
+            while (c->pendentes < (size_t)janela && emitidos < total) {
+                if (!carga_montar(c, &x)) { erro = 1; break; }
+                c->envio[(c->cabeca + c->pendentes) % (size_t)janela] = agora;
+                c->pendentes++;
+                emitidos++;
+            }
+            while (c->enviado < c->saida.tamanho) {
+                ssize_t k = send(c->fd, (char *)c->saida.dados + c->enviado, c->saida.tamanho - c->enviado, MSG_NOSIGNAL);
+                if (k > 0) { c->enviado += (size_t)k; continue; }
+                if (k < 0 && (errno == EAGAIN || errno == EINTR)) break;
+                erro = 1; break;
+            }
+            if (c->enviado == c->saida.tamanho) c->saida.tamanho = c->enviado = 0;
+            struct epoll_event ev = { .events = EPOLLIN | (c->saida.tamanho ? EPOLLOUT : 0), .data.ptr = c };
+            epoll_ctl(ep, EPOLL_CTL_MOD, c->fd, &ev);
+        }
+        if (erro) { fprintf(stderr, "[CARGA] Conexao perdida.\n"); break; }
+    }
+    double seg = agora_s() - t0;
+
+    if (recebidos > 0) {
+        qsort(latencias, (size_t)recebidos, sizeof(double), comparar_double);
+        printf("[CARGA] %d conexoes, janela %d, %lld respostas em %.3f s: %.0f pedidos/s\n",
+               abertas, janela, recebidos, seg, (double)recebidos / seg);
+        printf("[CARGA] Latencia (us): p50 %.1f | p90 %.1f | p99 %.1f | p99.9 %.1f | max %.1f\n",
+               percentil(latencias, recebidos, 0.50), percentil(latencias, recebidos, 0.90), percentil(latencias, recebidos, 0.99),
+               percentil(latencias, recebidos, 0.999), latencias[recebidos - 1]);
+        printf("[CARGA] Status: ok %lld | nao encontrado %lld | invalido %lld | sem memoria %lld | fora de ordem %lld\n",
+               status[ST_OK], status[ST_NAO_ENCONTRADO], status[ST_INVALIDO], status[ST_SEM_MEMORIA], fora_de_ordem);
+    }
+    for (int i = 0; i < nconexoes; ++i) {
+        if (cs[i].fd > 0) close(cs[i].fd);
+        free(cs[i].envio);
+        vc_liberar(&cs[i].saida);
+        vc_liberar(&cs[i].entrada);
+    }
+    free(cs);
+    free(latencias);
+    close(ep);
+    return abertas == nconexoes && recebidos == total ? 0 : 1;
+}
+#endif /* __linux__ */
+
+#ifdef MC_DISPONIVEL
+/* =====================================
+   MODO ESPECTADOR: le o vetor do modulo 2 direto da memoria compartilhada
+   - mapeamento so leitura, itens usados no lugar (sem copia, sem IPC)
+   - a tela e formatada dentro do seqlock e so impressa depois de validada;
+     ate la os textos podem estar no meio de uma escrita (sem '\0'), entao
+     so sao lidos com limite (%.*s) dentro dos campos
+   ===================================== */
+#define ESPECTADOR_INTERVALO_MS 200
+
+/* Acrescenta texto formatado ao buffer da tela; 0 = sem memoria */
+int tela_anexar(VetorCrescente *tela, const char *fmt, ...) {
+    char linha[256];
+    va_list ap; va_start(ap, fmt);
+    int n = vsnprintf(linha, sizeof linha, fmt, ap);
+    va_end(ap);
+    if (n < 0) return 0;
+    if ((size_t)n >= sizeof linha) n = (int)sizeof linha - 1;
+    if (!vc_garantir(tela, tela->tamanho + (size_t)n + 1)) return 0;
+    memcpy((char *)tela->dados + tela->tamanho, linha, (size_t)n + 1);
+    tela->tamanho += (size_t)n; /* o '\0' fica logo depois, fora do tamanho */
+    return 1;
+}
+
+/* atualizacoes = quantas versoes diferentes mostrar (0 = ate o jogo desligar o espelho) */
+int espectador_executar(const char *nome, long atualizacoes) {
+    LeitorMc l;
+    if (!mc_abrir(&l, nome, sizeof(Item2))) {
+        fprintf(stderr, "Segmento %s indisponivel (ligue a opcao 23 do modulo 2 no jogo).\n", nome);
+        return 1;
+    }
+    VetorCrescente tela; vc_init(&tela, 1);
+    uint64_t mostrada = 1; /* impar: nunca e um numero de sequencia valido */
+    long mostradas = 0;
+    while (atualizacoes == 0 || mostradas < atualizacoes) {
+        uint64_t seq;
+        int ok = 1;
+        do {
+            seq = mc_ler_inicio(&l);
+            if (seq == mostrada) break;
+            const Item2 *it = mc_itens(&l);
+            size_t n = mc_tamanho(&l);
+            tela.tamanho = 0;
+            ok = tela_anexar(&tela, "=== Espectador %s | versao %llu | %zu itens ===\n", nome, (unsigned long long)(seq / 2), n);
+            for (size_t i = 0; ok && i < n; ++i)
+                ok = tela_anexar(&tela, "%zu) %.*s | %.*s | %d\n", i + 1, TAM_NOME - 1, it[i].nome,
+                                 TAM_TIPO - 1, it[i].tipo, it[i].quantidade);
+        } while (!mc_ler_fim(&l, seq));
+        if (!ok) { fprintf(stderr, "Memoria insuficiente.\n"); break; }
+        if (seq != mostrada) {
+            fwrite(tela.dados, 1, tela.tamanho, stdout);
+            fflush(stdout);
+            mostrada = seq;
+            mostradas++;
+        }
+        if (!mc_escritor_ativo(&l)) { printf("[Espectador] O jogo desligou o espelho.\n"); break; }
+        struct timespec pausa = { 0, ESPECTADOR_INTERVALO_MS * 1000000L };
+        nanosleep(&pausa, NULL);
+    }
+    printf("[Espectador] %ld versoes mostradas, %zu leituras refeitas.\n", mostradas, l.repeticoes);
+    vc_liberar(&tela);
+    mc_fechar(&l);
+    return 0;
 }
+#endif /* MC_DISPONIVEL */
 
 /* ---------------------------
-   MENU MESTRE (integra os 3 módulos)
+   MENU MESTRE (integra os 4 módulos)
    --------------------------- */
-int main(void) {
+int main(int argc, char **argv) {
+#ifdef __linux__
+    if (argc > 1 && strcmp(argv[1], "--servidor") == 0) return servidor_executar(argc > 2 ? argv[2] : SRV_CAMINHO_PADRAO);
+    if (argc > 1 && strcmp(argv[1], "--carga") == 0) return carga_executar(argc, argv);
+#endif
+#ifdef MC_DISPONIVEL
+    if (argc > 1 && strcmp(argv[1], "--espectador") == 0)
+        return espectador_executar(argc > 2 ? argv[2] : MC_NOME_PADRAO, argc > 3 ? strtol(argv[3], NULL, 10) : 0);
+#endif
+#if !defined(__linux__) && !defined(MC_DISPONIVEL)
+    (void)argc; (void)argv;
+#endif
     printf("=== JOGO: Sistema Integrado de Inventario e Prioridades ===\n");
     int opc;
     do {
         separador();
-        printf("Escolha o modulo:\n1 - Inventario simples (vetor fixo)\n2 - Comparativo (vetor dinamico x lista)\n3 - Torre de fuga (ordenacoes e busca)\n0 - Sair\nOpcao: ");
-        if (scanf("%d", &opc) != 1) { limpar_buffer(); opc = -1; }
+        printf("Escolha o modulo:\n1 - Inventario simples (vetor crescente)\n2 - Comparativo (vetor dinamico x lista)\n3 - Torre de fuga (ordenacoes e busca)\n4 - Servidor de mochilas (varios jogadores)\n0 - Sair\nOpcao: ");
+        { int r = entrada_ler_int(&opc); if (r != 1) opc = (r == EOF) ? 0 : -1; }
         limpar_buffer();
         switch (opc) {
             case 1: modulo1(); break;
             case 2: modulo2(); break;
             case 3: modulo3(); break;
+            case 4: modulo4(); break;
             case 0: printf("Saindo. Boa sorte no jogo — e evite a zona vermelha!\n"); break;
             default: printf("Opcao invalida.\n");
         }
     } while (opc != 0);
+    tipos_liberar();
     return 0;
 }
\ No newline at end of file
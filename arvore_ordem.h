@@ -0,0 +1,171 @@
+/*
+ * arvore_ordem.h
+ *
+ * Arvore de estatistica de ordem: "em que posicao esta o item X" e "qual e
+ * o K-esimo item" sem ordenar o vetor.
+ *  - treap ordenada pelo comparador, cada no guarda o tamanho da subarvore
+ *  - inserir/remover/posto/selecionar em O(log n) esperado; a arvore e
+ *    mantida a cada mudanca, nunca reconstruida para uma consulta
+ *  - o comparador deve ser uma ordem total (desempatar ate o fim); elementos
+ *    iguais em tudo sao intercambiaveis
+ *
+ * Uma arvore por criterio:
+ *   ArvoreOrdem a; ao_init(&a, sizeof(Item), comparar_total, &crit);
+ *   ao_inserir(&a, &item); ao_remover(&a, &item);
+ *   size_t pos = ao_posto(&a, &item);            // 1-based, 0 = ausente
+ *   const Item *k = ao_selecionar(&a, 500);      // NULL se fora do intervalo
+ */
+#ifndef ARVORE_ORDEM_H
+#define ARVORE_ORDEM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef int (*ComparadorAo)(const void *a, const void *b, void *ctx);
+
+typedef struct AoNo {
+    struct AoNo *esq, *dir;
+    size_t tamanho;        /* nos na subarvore */
+    uint32_t prioridade;   /* heap da treap (maior em cima) */
+    unsigned char dados[]; /* o elemento (tam_elem bytes) */
+} AoNo;
+
+typedef struct {
+    AoNo *raiz;
+    size_t tam_elem;
+    ComparadorAo cmp;
+    void *ctx;
+    long long comparacoes; /* acumulado de todas as operacoes */
+    uint32_t semente;
+} ArvoreOrdem;
+
+static inline void ao_init(ArvoreOrdem *a, size_t tam_elem, ComparadorAo cmp, void *ctx) {
+    a->raiz = NULL;
+    a->tam_elem = tam_elem;
+    a->cmp = cmp;
+    a->ctx = ctx;
+    a->comparacoes = 0;
+    a->semente = 2463534242u;
+}
+
+static inline size_t ao_tam(const AoNo *n) { return n ? n->tamanho : 0; }
+
+static inline size_t ao_tamanho(const ArvoreOrdem *a) { return ao_tam(a->raiz); }
+
+static inline void ao_atualizar(AoNo *n) { n->tamanho = 1 + ao_tam(n->esq) + ao_tam(n->dir); }
+
+static inline int ao_comparar(ArvoreOrdem *a, const void *x, const AoNo *n) {
+    a->comparacoes++;
+    return a->cmp(x, n->dados, a->ctx);
+}
+
+/* Divide t em [< elem] e [>= elem] */
+static inline void ao_dividir(ArvoreOrdem *a, AoNo *t, const void *elem, AoNo **menores, AoNo **resto) {
+    if (!t) { *menores = *resto = NULL; return; }
+    if (ao_comparar(a, elem, t) <= 0) {
+        ao_dividir(a, t->esq, elem, menores, &t->esq);
+        *resto = t;
+    } else {
+        ao_dividir(a, t->dir, elem, &t->dir, resto);
+        *menores = t;
+    }
+    ao_atualizar(t);
+}
+
+/* Concatena x e y (todo x antes de todo y) */
+static inline AoNo *ao_juntar(AoNo *x, AoNo *y) {
+    if (!x) return y;
+    if (!y) return x;
+    if (x->prioridade >= y->prioridade) {
+        x->dir = ao_juntar(x->dir, y);
+        ao_atualizar(x);
+        return x;
+    }
+    y->esq = ao_juntar(x, y->esq);
+    ao_atualizar(y);
+    return y;
+}
+
+/* 0 = sem memoria (a arvore nao muda) */
+static inline int ao_inserir(ArvoreOrdem *a, const void *elem) {
+    AoNo *n = malloc(sizeof(AoNo) + a->tam_elem);
+    if (!n) return 0;
+    memcpy(n->dados, elem, a->tam_elem);
+    n->esq = n->dir = NULL;
+    n->tamanho = 1;
+    a->semente ^= a->semente << 13; /* xorshift32 */
+    a->semente ^= a->semente >> 17;
+    a->semente ^= a->semente << 5;
+    n->prioridade = a->semente;
+    AoNo *menores, *resto;
+    ao_dividir(a, a->raiz, elem, &menores, &resto);
+    a->raiz = ao_juntar(ao_juntar(menores, n), resto);
+    return 1;
+}
+
+/* Remove uma ocorrencia de elem; 0 = nao estava na arvore */
+static inline int ao_remover_no(ArvoreOrdem *a, AoNo **p, const void *elem) {
+    AoNo *n = *p;
+    if (!n) return 0;
+    int c = ao_comparar(a, elem, n);
+    if (c == 0) {
+        *p = ao_juntar(n->esq, n->dir);
+        free(n);
+        return 1;
+    }
+    if (!ao_remover_no(a, c < 0 ? &n->esq : &n->dir, elem)) return 0;
+    n->tamanho--;
+    return 1;
+}
+
+static inline int ao_remover(ArvoreOrdem *a, const void *elem) { return ao_remover_no(a, &a->raiz, elem); }
+
+/* Posicao 1-based de elem na ordem da arvore; 0 = ausente */
+static inline size_t ao_posto(ArvoreOrdem *a, const void *elem) {
+    size_t menores = 0;
+    for (const AoNo *n = a->raiz; n;) {
+        int c = ao_comparar(a, elem, n);
+        if (c == 0) return menores + ao_tam(n->esq) + 1;
+        if (c < 0) n = n->esq;
+        else { menores += ao_tam(n->esq) + 1; n = n->dir; }
+    }
+    return 0;
+}
+
+/* K-esimo elemento (1-based); NULL fora de [1, tamanho] */
+static inline const void *ao_selecionar(const ArvoreOrdem *a, size_t k) {
+    if (k == 0 || k > ao_tamanho(a)) return NULL;
+    const AoNo *n = a->raiz;
+    for (;;) {
+        size_t e = ao_tam(n->esq);
+        if (k == e + 1) return n->dados;
+        if (k <= e) n = n->esq;
+        else { k -= e + 1; n = n->dir; }
+    }
+}
+
+static inline void ao_soltar(AoNo *n) {
+    while (n) {
+        AoNo *dir = n->dir;
+        ao_soltar(n->esq);
+        free(n);
+        n = dir;
+    }
+}
+
+static inline void ao_liberar(ArvoreOrdem *a) {
+    ao_soltar(a->raiz);
+    a->raiz = NULL;
+}
+
+/* Troca o conteudo por dados[0..n) (ex.: depois de desfazer); 0 = sem memoria */
+static inline int ao_carregar(ArvoreOrdem *a, const void *dados, size_t n) {
+    ao_liberar(a);
+    for (size_t i = 0; i < n; i++)
+        if (!ao_inserir(a, (const unsigned char *)dados + i * a->tam_elem)) return 0;
+    return 1;
+}
+
+#endif /* ARVORE_ORDEM_H */
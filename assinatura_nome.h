@@ -0,0 +1,60 @@
+/*
+ * assinatura_nome.h
+ *
+ * Assinatura do nome (tamanho + hash FNV-1a), calculada uma vez na insercao
+ * e guardada junto do item.
+ *  - igualdade rejeita pela assinatura antes de percorrer os bytes com
+ *    strcmp; nomes com prefixo comum ("Kit ...", "Municao ...") quase nunca
+ *    chegam ao strcmp
+ *  - o hash guardado tambem serve de entrada para filtros de Bloom e tabelas
+ *
+ * Uso:
+ *   item.assinatura = assinar_nome(item.nome);      // na insercao
+ *   AssinaturaNome an = assinar_nome(busca);        // uma vez por busca
+ *   if (nome_igual(item.nome, item.assinatura, busca, an)) ...
+ */
+#ifndef ASSINATURA_NOME_H
+#define ASSINATURA_NOME_H
+
+#include <stdint.h>
+#include <string.h>
+
+typedef struct {
+    uint32_t hash;
+    int tam;
+} AssinaturaNome;
+
+/* Hash FNV-1a de 32 bits do nome */
+static inline uint32_t hash_nome(const char *s) {
+    uint32_t h = 2166136261u;
+    while (*s) { h ^= (unsigned char)*s++; h *= 16777619u; }
+    return h;
+}
+
+static inline AssinaturaNome assinar_nome(const char *nome) {
+    AssinaturaNome a;
+    a.hash = hash_nome(nome);
+    a.tam = (int)strlen(nome);
+    return a;
+}
+
+/* strcmp realmente executados nas igualdades (um contador por programa) */
+static long long strcmp_igualdade = 0;
+
+/* Mesma igualdade sem contador global: segura para leitores em paralelo */
+static inline int nome_igual_puro(const char *nome, AssinaturaNome a, const char *busca, AssinaturaNome b) {
+    return a.tam == b.tam && a.hash == b.hash && strcmp(nome, busca) == 0;
+}
+
+/* Conta em *strcmps so os strcmp que passaram pela assinatura (contador de quem chama) */
+static inline int nome_igual_contado(const char *nome, AssinaturaNome a, const char *busca, AssinaturaNome b, long long *strcmps) {
+    if (a.tam != b.tam || a.hash != b.hash) return 0;
+    (*strcmps)++;
+    return nome_igual_puro(nome, a, busca, b);
+}
+
+static inline int nome_igual(const char *nome, AssinaturaNome a, const char *busca, AssinaturaNome b) {
+    return nome_igual_contado(nome, a, busca, b, &strcmp_igualdade);
+}
+
+#endif /* ASSINATURA_NOME_H */
@@ -0,0 +1,111 @@
+/*
+ * colacao.h
+ *
+ * Ordem alfabetica de verdade para nomes em UTF-8 ("Ácido" junto de "acido",
+ * "Munição" antes de "Muralha"), pagando o custo da colacao uma vez por item.
+ *  - cada item guarda uma chave de colacao (estilo strxfrm) calculada na
+ *    insercao; ordenar e buscar comparam chaves com memcmp
+ *  - com um locale de colacao configurado (LC_COLLATE/LANG, ex.: pt_BR.UTF-8)
+ *    a chave vem do strxfrm; no locale C/POSIX (sem locale instalado) usa uma
+ *    chave propria: letras sem acento e sem caixa, depois acentos, depois caixa
+ *  - a chave guarda os primeiros COLACAO_TAM_CHAVE bytes; os primeiros niveis
+ *    vem antes, entao quase toda comparacao decide ali. Empate de chaves
+ *    cortadas recalcula as chaves inteiras; empate total desempata com strcmp
+ *
+ * Uso:
+ *   colacao_iniciar();                         // uma vez, no inicio do main
+ *   colacao_chave(&item.chave_nome, item.nome);
+ *   colacao_comparar(&a.chave_nome, a.nome, &b.chave_nome, b.nome);
+ */
+#ifndef COLACAO_H
+#define COLACAO_H
+
+#include <locale.h>
+#include <stddef.h>
+#include <string.h>
+
+#define COLACAO_TAM_CHAVE 64
+#define COLACAO_TAM_MAX 512 /* chave inteira (so no desempate de chaves cortadas) */
+
+typedef struct {
+    unsigned char bytes[COLACAO_TAM_CHAVE]; /* completada com zeros; ultimo byte != 0 = cortada */
+} ChaveColacao;
+
+static int colacao_usa_locale = 0;
+
+/* Le LC_COLLATE do ambiente; devolve o nome do locale em uso */
+static inline const char *colacao_iniciar(void) {
+    const char *nome = setlocale(LC_COLLATE, "");
+    if (!nome) nome = setlocale(LC_COLLATE, NULL);
+    colacao_usa_locale = nome && !(nome[0] == 'C' && (nome[1] == '\0' || nome[1] == '.')) && strcmp(nome, "POSIX") != 0;
+    return colacao_usa_locale ? nome : "interna (pt-BR)";
+}
+
+/*
+ * Chave propria para o locale C: U+00C0..U+00FF (bytes 0xC3 0x80..0xBF) viram
+ * a letra base; minusculas antes de maiusculas, sem acento antes de com acento.
+ */
+static const char colacao_base_latin1[64] =
+    "aaaaaaaceeeeiiiidnooooo*ouuuuyts"
+    "aaaaaaaceeeeiiiidnooooo/ouuuuyty";
+
+static inline size_t colacao_transformar_interna(unsigned char *dst, size_t tam, const char *s) {
+    size_t n = 0;
+    /* nivel 1: letra base minuscula | nivel 2: acento | nivel 3: caixa */
+    for (int nivel = 1; nivel <= 3; nivel++) {
+        if (nivel > 1) { if (n < tam) dst[n] = 1; n++; } /* separador menor que qualquer peso */
+        for (const unsigned char *p = (const unsigned char *)s; *p; p++) {
+            unsigned char base = *p, acento = 2, caixa = 2;
+            if (*p == 0xC3 && p[1] >= 0x80 && p[1] <= 0xBF) {
+                unsigned codigo = p[1] + 0x40u; /* U+00C0..U+00FF */
+                base = (unsigned char)colacao_base_latin1[codigo - 0xC0];
+                acento = (unsigned char)(3 + (codigo & 0x1F)); /* grave, agudo, circunflexo, til... */
+                if (codigo < 0xDF && codigo != 0xD7) caixa = 3;
+                p++;
+            } else if (*p >= 'A' && *p <= 'Z') {
+                base = (unsigned char)(*p - 'A' + 'a');
+                caixa = 3;
+            }
+            unsigned char peso = nivel == 1 ? base : nivel == 2 ? acento : caixa;
+            if (n < tam) dst[n] = peso;
+            n++;
+        }
+    }
+    return n;
+}
+
+/* Chave inteira de s em dst[0..tam); devolve o tamanho total (como o strxfrm) */
+static inline size_t colacao_transformar(unsigned char *dst, size_t tam, const char *s) {
+    if (colacao_usa_locale) {
+        size_t n = strxfrm((char *)dst, s, tam);
+        if (n >= tam) {
+            /* o conteudo e indefinido quando nao cabe: refaz num buffer grande e corta */
+            char grande[COLACAO_TAM_MAX];
+            if (strxfrm(grande, s, sizeof grande) >= sizeof grande) grande[sizeof grande - 1] = '\0';
+            memcpy(dst, grande, tam);
+        }
+        return n;
+    }
+    return colacao_transformar_interna(dst, tam, s);
+}
+
+static inline void colacao_chave(ChaveColacao *k, const char *s) {
+    memset(k->bytes, 0, sizeof k->bytes);
+    colacao_transformar(k->bytes, sizeof k->bytes, s);
+}
+
+static inline int colacao_comparar(const ChaveColacao *a, const char *sa, const ChaveColacao *b, const char *sb) {
+    int c = memcmp(a->bytes, b->bytes, COLACAO_TAM_CHAVE);
+    if (c != 0) return c;
+    if (a->bytes[COLACAO_TAM_CHAVE - 1] != 0) {
+        /* as duas cortadas no mesmo ponto: compara as chaves inteiras */
+        unsigned char x[COLACAO_TAM_MAX] = {0}, y[COLACAO_TAM_MAX] = {0};
+        colacao_transformar(x, sizeof x, sa);
+        colacao_transformar(y, sizeof y, sb);
+        c = memcmp(x, y, sizeof x);
+        if (c != 0) return c;
+    }
+    return strcmp(sa, sb);
+}
+
+#endif /* COLACAO_H */
@@ -0,0 +1,145 @@
+/*
+ * entrada_rapida.h
+ *
+ * Camada de entrada compartilhada pelos niveis (substitui scanf/getchar/fgets).
+ *  - le o stdin em blocos grandes com read() e tokeniza linhas e inteiros
+ *    direto no buffer: sem scanf, sem lock do stdio por campo
+ *  - sessoes gravadas via pipe rodam na velocidade do bloco; no terminal o
+ *    read() devolve uma linha por vez, entao o comportamento nao muda
+ *  - antes de esperar por mais dados o stdout e descarregado, para que os
+ *    prompts sem '\n' ("Escolha: ") aparecam como antes
+ *
+ * Equivalencias:
+ *   scanf("%d", &x)            -> entrada_ler_int(&x)
+ *   getchar() / limpar_buffer  -> entrada_descartar_linha()
+ *   fgets + remover '\n'       -> entrada_ler_linha(buf, tam)
+ *
+ * Todo o stdin do programa deve passar por aqui (o buffer nao e o do stdio).
+ */
+#ifndef ENTRADA_RAPIDA_H
+#define ENTRADA_RAPIDA_H
+
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#define ENTRADA_POSIX 1
+#endif
+
+#define ENTRADA_BLOCO (64 * 1024)
+
+static char entrada_buf[ENTRADA_BLOCO];
+static size_t entrada_pos = 0, entrada_fim_dados = 0;
+static int entrada_eof = 0;
+
+/* Recarrega o buffer; 0 = fim da entrada */
+static inline int entrada_recarregar(void) {
+    if (entrada_eof) return 0;
+    fflush(stdout);
+    entrada_pos = 0;
+    entrada_fim_dados = 0;
+#ifdef ENTRADA_POSIX
+    ssize_t n;
+    do { n = read(STDIN_FILENO, entrada_buf, sizeof entrada_buf); } while (n < 0 && errno == EINTR);
+    if (n <= 0) { entrada_eof = 1; return 0; }
+    entrada_fim_dados = (size_t)n;
+#else
+    /* Sem read(): uma linha por vez via fgets (mantem o terminal interativo) */
+    if (!fgets(entrada_buf, sizeof entrada_buf, stdin)) { entrada_eof = 1; return 0; }
+    entrada_fim_dados = strlen(entrada_buf);
+#endif
+    return 1;
+}
+
+/* Proximo caractere sem consumir; EOF no fim da entrada */
+static inline int entrada_espiar(void) {
+    if (entrada_pos == entrada_fim_dados && !entrada_recarregar()) return EOF;
+    return (unsigned char)entrada_buf[entrada_pos];
+}
+
+static inline int entrada_proximo(void) {
+    int c = entrada_espiar();
+    if (c != EOF) entrada_pos++;
+    return c;
+}
+
+/* Descarta o restante da linha atual, inclusive o '\n' */
+static inline void entrada_descartar_linha(void) {
+    for (;;) {
+        if (entrada_pos == entrada_fim_dados && !entrada_recarregar()) return;
+        char *nl = memchr(entrada_buf + entrada_pos, '\n', entrada_fim_dados - entrada_pos);
+        if (nl) { entrada_pos = (size_t)(nl - entrada_buf) + 1; return; }
+        entrada_pos = entrada_fim_dados;
+    }
+}
+
+/*
+ * Copia a proxima linha (sem o '\n') para buffer, truncando em tamanho-1.
+ * Como o fgets original, o excesso de uma linha longa fica para a proxima leitura.
+ * Devolve 0 se a entrada acabou antes de qualquer caractere.
+ */
+static inline int entrada_ler_linha(char *buffer, int tamanho) {
+    size_t n = 0, max = tamanho > 0 ? (size_t)tamanho - 1 : 0;
+    int leu = 0;
+    while (n < max) {
+        if (entrada_pos == entrada_fim_dados && !entrada_recarregar()) break;
+        leu = 1;
+        size_t disp = entrada_fim_dados - entrada_pos;
+        if (disp > max - n) disp = max - n;
+        char *ini = entrada_buf + entrada_pos;
+        char *nl = memchr(ini, '\n', disp);
+        if (nl) {
+            size_t k = (size_t)(nl - ini);
+            memcpy(buffer + n, ini, k); n += k;
+            entrada_pos += k + 1;
+            break;
+        }
+        memcpy(buffer + n, ini, disp); n += disp;
+        entrada_pos += disp;
+    }
+    if (tamanho > 0) buffer[n] = '\0';
+    return leu;
+}
+
+/* Pula espacos/linhas e le um inteiro com sinal (como scanf "%d" / "%zu") */
+static inline int entrada_ler_numero(long long *v, int aceita_sinal) {
+    int c;
+    while ((c = entrada_espiar()) == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f')
+        entrada_pos++;
+    if (c == EOF) return EOF;
+    int negativo = 0;
+    if (aceita_sinal && (c == '-' || c == '+')) {
+        negativo = (c == '-');
+        entrada_pos++;
+        c = entrada_espiar();
+    }
+    if (c < '0' || c > '9') return 0; /* token invalido fica no buffer, como no scanf */
+    unsigned long long acc = 0;
+    while ((c = entrada_espiar()) >= '0' && c <= '9') {
+        if (acc <= (UINT64_MAX - 9) / 10) acc = acc * 10 + (unsigned)(c - '0');
+        entrada_pos++;
+    }
+    if (acc > (unsigned long long)INT64_MAX) acc = (unsigned long long)INT64_MAX;
+    *v = negativo ? -(long long)acc : (long long)acc;
+    return 1;
+}
+
+static inline int entrada_ler_int(int *v) {
+    long long x;
+    int r = entrada_ler_numero(&x, 1);
+    if (r == 1) *v = x > INT_MAX ? INT_MAX : (x < INT_MIN ? INT_MIN : (int)x);
+    return r;
+}
+
+static inline int entrada_ler_size(size_t *v) {
+    long long x;
+    int r = entrada_ler_numero(&x, 0);
+    if (r == 1) *v = (size_t)x;
+    return r;
+}
+
+#endif /* ENTRADA_RAPIDA_H */
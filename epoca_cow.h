@@ -0,0 +1,144 @@
+/*
+ * epoca_cow.h
+ *
+ * Fotos imutaveis de um vetor para leitores (listagens, buscas) enquanto o escritor
+ * continua mudando o seu vetor de trabalho.
+ *  - o escritor publica uma copia (copy-on-write) quando ha mudanca pendente;
+ *    a versao antiga e "retirada" com a epoca atual
+ *  - o leitor so anuncia a epoca e pega o ponteiro da versao: O(1), sem lock,
+ *    e a versao nao muda enquanto ele renderiza
+ *  - uma versao retirada so e liberada quando nenhum leitor ativo anunciou uma
+ *    epoca <= a da retirada (ninguem mais pode estar com ela na mao)
+ *
+ * Uso (escritor):  cow_publicar(&c, itens, n, sizeof(Item));
+ * Uso (leitor):    int s = cow_leitor_entrar(&c);
+ *                  const VersaoCow *f = cow_ler(&c, s); ... cow_soltar(&c, s);
+ *                  cow_leitor_sair(&c, s);
+ * Um unico escritor por canal; ate EPOCA_MAX_LEITORES leitores simultaneos.
+ */
+#ifndef EPOCA_COW_H
+#define EPOCA_COW_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define EPOCA_MAX_LEITORES 16
+
+typedef struct VersaoCow {
+    struct VersaoCow *prox_retirada;
+    size_t epoca_retirada;
+    size_t tamanho;
+    unsigned marcas; /* bits de quem publica (ex.: COW_ORDENADA) */
+    _Alignas(max_align_t) unsigned char dados[];
+} VersaoCow;
+
+#define COW_ITENS(f, T) ((const T *)(f)->dados)
+#define COW_ORDENADA 1u /* versao ordenada pela chave de busca */
+
+typedef struct {
+    _Atomic(VersaoCow *) atual;
+    atomic_size_t epoca;                        /* epoca global, comeca em 1 */
+    atomic_size_t anunciada[EPOCA_MAX_LEITORES]; /* 0 = leitor fora */
+    atomic_int ocupado[EPOCA_MAX_LEITORES];
+    /* Do escritor (sem concorrencia) */
+    VersaoCow *retiradas;
+    size_t publicadas, recuperadas, pendentes, pico_pendentes;
+} CanalCow;
+
+static inline void cow_init(CanalCow *c) {
+    atomic_init(&c->atual, NULL);
+    atomic_init(&c->epoca, 1);
+    for (int i = 0; i < EPOCA_MAX_LEITORES; i++) {
+        atomic_init(&c->anunciada[i], 0);
+        atomic_init(&c->ocupado[i], 0);
+    }
+    c->retiradas = NULL;
+    c->publicadas = c->recuperadas = c->pendentes = c->pico_pendentes = 0;
+}
+
+/* ---------------- Leitor ---------------- */
+
+/* Reserva uma vaga de leitor; -1 se todas estao ocupadas */
+static inline int cow_leitor_entrar(CanalCow *c) {
+    for (int i = 0; i < EPOCA_MAX_LEITORES; i++) {
+        int livre = 0;
+        if (atomic_compare_exchange_strong(&c->ocupado[i], &livre, 1)) return i;
+    }
+    return -1;
+}
+
+static inline void cow_leitor_sair(CanalCow *c, int s) { atomic_store(&c->ocupado[s], 0); }
+
+/* Anuncia a epoca e devolve a versao publicada (NULL se nada foi publicado) */
+static inline const VersaoCow *cow_ler(CanalCow *c, int s) {
+    atomic_store(&c->anunciada[s], atomic_load(&c->epoca));
+    return atomic_load(&c->atual);
+}
+
+static inline void cow_soltar(CanalCow *c, int s) { atomic_store(&c->anunciada[s], 0); }
+
+/* ---------------- Escritor ---------------- */
+
+/* Libera as versoes retiradas que nenhum leitor ativo pode estar usando */
+static inline void cow_recuperar(CanalCow *c) {
+    size_t minima = (size_t)-1;
+    for (int i = 0; i < EPOCA_MAX_LEITORES; i++) {
+        size_t e = atomic_load(&c->anunciada[i]);
+        if (e && e < minima) minima = e;
+    }
+    VersaoCow **p = &c->retiradas;
+    while (*p) {
+        VersaoCow *r = *p;
+        if (r->epoca_retirada < minima) {
+            *p = r->prox_retirada;
+            free(r);
+            c->recuperadas++;
+            c->pendentes--;
+        } else {
+            p = &r->prox_retirada;
+        }
+    }
+}
+
+/* Publica uma copia de dados[0..n); 0 = sem memoria (a versao anterior continua valendo) */
+static inline int cow_publicar_marcado(CanalCow *c, const void *dados, size_t n, size_t tam_elem, unsigned marcas) {
+    if (n > (SIZE_MAX - sizeof(VersaoCow)) / (tam_elem ? tam_elem : 1)) return 0;
+    VersaoCow *nova = malloc(sizeof(VersaoCow) + n * tam_elem);
+    if (!nova) return 0;
+    nova->prox_retirada = NULL;
+    nova->epoca_retirada = 0;
+    nova->tamanho = n;
+    nova->marcas = marcas;
+    if (n) memcpy(nova->dados, dados, n * tam_elem);
+    VersaoCow *antiga = atomic_exchange(&c->atual, nova);
+    c->publicadas++;
+    if (antiga) {
+        /* leitores que anunciarem depois do incremento ja enxergam 'nova' */
+        antiga->epoca_retirada = atomic_fetch_add(&c->epoca, 1);
+        antiga->prox_retirada = c->retiradas;
+        c->retiradas = antiga;
+        if (++c->pendentes > c->pico_pendentes) c->pico_pendentes = c->pendentes;
+    }
+    cow_recuperar(c);
+    return 1;
+}
+
+static inline int cow_publicar(CanalCow *c, const void *dados, size_t n, size_t tam_elem) {
+    return cow_publicar_marcado(c, dados, n, tam_elem, 0);
+}
+
+/* Sem leitores ativos: libera a versao atual e as retiradas */
+static inline void cow_liberar(CanalCow *c) {
+    while (c->retiradas) {
+        VersaoCow *r = c->retiradas;
+        c->retiradas = r->prox_retirada;
+        free(r);
+    }
+    free(atomic_exchange(&c->atual, NULL));
+    c->pendentes = 0;
+}
+
+#endif /* EPOCA_COW_H */
@@ -0,0 +1,210 @@
+/*
+ * memoria_compartilhada.h
+ *
+ * Vetor publicado num segmento POSIX (shm_open) para outros processos
+ * (overlay do HUD, espectador) lerem sem copia e sem ida e volta de IPC.
+ *  - um escritor: mc_publicar copia o vetor para o segmento dentro de um
+ *    seqlock (contador impar = atualizacao em andamento)
+ *  - leitores mapeiam o segmento so para leitura e usam os itens no lugar:
+ *      do { s = mc_ler_inicio(&l); ...usa mc_itens/mc_tamanho... } while (!mc_ler_fim(&l, s));
+ *    o leitor nunca bloqueia o escritor; se ele escreveu no meio, a leitura
+ *    e refeita (quem le deve so calcular/formatar, e agir depois de validar)
+ *  - o segmento so cresce (dobra quando falta espaco); o leitor remapeia
+ *    quando a capacidade publicada passa do que ele tem mapeado
+ *
+ * Uso (escritor): SegmentoMc s; mc_criar(&s, "/mochila_jogo", sizeof(Item), 64);
+ *                 mc_publicar(&s, itens, n); ... mc_remover(&s);
+ * Uso (leitor):   LeitorMc l; mc_abrir(&l, "/mochila_jogo", sizeof(Item)); ... mc_fechar(&l);
+ * Em glibc < 2.34 compilar com -lrt.
+ */
+#ifndef MEMORIA_COMPARTILHADA_H
+#define MEMORIA_COMPARTILHADA_H
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MC_DISPONIVEL 1
+
+#include <fcntl.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MC_MAGICO 0x4D4F4348u /* "MOCH" */
+#define MC_NOME_PADRAO "/mochila_jogo"
+#define MC_TAM_NOME 64
+
+_Static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "seqlock entre processos precisa de atomicos de 64 bits sem trava");
+
+typedef struct {
+    uint32_t magico;
+    uint32_t tam_elem;
+    atomic_uint_least64_t seq;         /* seqlock: impar = escritor no meio */
+    atomic_uint_least64_t tamanho;     /* elementos validos */
+    atomic_uint_least64_t capacidade;  /* elementos que cabem no segmento */
+    atomic_uint_least64_t publicacoes;
+    atomic_int ativo;                  /* 0 = escritor saiu (leitores podem encerrar) */
+    _Alignas(64) unsigned char dados[];
+} CabecalhoMc;
+
+/* ---------------- Escritor ---------------- */
+
+typedef struct {
+    char nome[MC_TAM_NOME];
+    int fd;
+    CabecalhoMc *cab;
+    size_t bytes;              /* mapeados */
+    size_t crescimentos;
+    double ultima_publicacao_ms;
+} SegmentoMc;
+
+static inline size_t mc_bytes(size_t tam_elem, size_t capacidade) {
+    return sizeof(CabecalhoMc) + tam_elem * capacidade;
+}
+
+/* 1 = ok; 0 = falhou (errno do sistema ja impresso) */
+static inline int mc_criar(SegmentoMc *s, const char *nome, size_t tam_elem, size_t capacidade) {
+    if (capacidade == 0) capacidade = 1;
+    snprintf(s->nome, sizeof s->nome, "%s", nome);
+    s->fd = shm_open(s->nome, O_CREAT | O_RDWR, 0644);
+    if (s->fd < 0) { perror("shm_open"); return 0; }
+    s->bytes = mc_bytes(tam_elem, capacidade);
+    if (ftruncate(s->fd, (off_t)s->bytes) != 0) { perror("ftruncate"); close(s->fd); shm_unlink(s->nome); return 0; }
+    void *p = mmap(NULL, s->bytes, PROT_READ | PROT_WRITE, MAP_SHARED, s->fd, 0);
+    if (p == MAP_FAILED) { perror("mmap"); close(s->fd); shm_unlink(s->nome); return 0; }
+    s->cab = p;
+    s->cab->magico = MC_MAGICO;
+    s->cab->tam_elem = (uint32_t)tam_elem;
+    atomic_init(&s->cab->seq, 0);
+    atomic_init(&s->cab->tamanho, 0);
+    atomic_init(&s->cab->capacidade, capacidade);
+    atomic_init(&s->cab->publicacoes, 0);
+    atomic_init(&s->cab->ativo, 1);
+    s->crescimentos = 0;
+    s->ultima_publicacao_ms = 0;
+    return 1;
+}
+
+/* Aumenta o segmento (o conteudo antigo continua valido para quem mapeou menos) */
+static inline int mc_crescer(SegmentoMc *s, size_t necessaria) {
+    size_t tam_elem = s->cab->tam_elem, cap = (size_t)atomic_load(&s->cab->capacidade);
+    while (cap < necessaria) cap *= 2;
+    size_t bytes = mc_bytes(tam_elem, cap);
+    if (ftruncate(s->fd, (off_t)bytes) != 0) return 0;
+    void *p = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, s->fd, 0);
+    if (p == MAP_FAILED) return 0;
+    munmap(s->cab, s->bytes);
+    s->cab = p;
+    s->bytes = bytes;
+    s->crescimentos++;
+    return 1;
+}
+
+/* Copia dados[0..n) para o segmento; 0 = sem espaco (o conteudo anterior fica) */
+static inline int mc_publicar(SegmentoMc *s, const void *dados, size_t n) {
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    if (n > atomic_load(&s->cab->capacidade) && !mc_crescer(s, n)) return 0;
+    CabecalhoMc *c = s->cab;
+    uint64_t seq = atomic_load_explicit(&c->seq, memory_order_relaxed);
+    atomic_store_explicit(&c->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release); /* impar visivel antes de qualquer dado novo */
+    atomic_store_explicit(&c->capacidade, (s->bytes - sizeof(CabecalhoMc)) / c->tam_elem, memory_order_relaxed);
+    atomic_store_explicit(&c->tamanho, n, memory_order_relaxed);
+    if (n) memcpy(c->dados, dados, n * c->tam_elem);
+    atomic_fetch_add_explicit(&c->publicacoes, 1, memory_order_relaxed);
+    atomic_store_explicit(&c->seq, seq + 2, memory_order_release);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    s->ultima_publicacao_ms = (double)(t1.tv_sec - t0.tv_sec) * 1000.0 + (double)(t1.tv_nsec - t0.tv_nsec) / 1e6;
+    return 1;
+}
+
+/* Avisa os leitores, desmapeia e apaga o nome (mapeamentos existentes continuam ate fecharem) */
+static inline void mc_remover(SegmentoMc *s) {
+    if (!s->cab) return;
+    atomic_store(&s->cab->ativo, 0);
+    munmap(s->cab, s->bytes);
+    close(s->fd);
+    shm_unlink(s->nome);
+    s->cab = NULL;
+}
+
+/* ---------------- Leitor ---------------- */
+
+typedef struct {
+    int fd;
+    const CabecalhoMc *cab;
+    size_t bytes;       /* mapeados */
+    size_t capacidade;  /* elementos dentro do mapeamento */
+    size_t repeticoes;  /* leituras refeitas porque o escritor mexeu no meio */
+} LeitorMc;
+
+static inline int mc_mapear(LeitorMc *l) {
+    struct stat st;
+    if (fstat(l->fd, &st) != 0 || (size_t)st.st_size < sizeof(CabecalhoMc)) return 0;
+    void *p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, l->fd, 0);
+    if (p == MAP_FAILED) return 0;
+    if (l->cab) munmap((void *)l->cab, l->bytes);
+    l->cab = p;
+    l->bytes = (size_t)st.st_size;
+    l->capacidade = l->cab->tam_elem ? (l->bytes - sizeof(CabecalhoMc)) / l->cab->tam_elem : 0;
+    return 1;
+}
+
+/* 1 = ok; 0 = segmento ausente ou de outro formato */
+static inline int mc_abrir(LeitorMc *l, const char *nome, size_t tam_elem) {
+    l->cab = NULL;
+    l->bytes = l->capacidade = l->repeticoes = 0;
+    l->fd = shm_open(nome, O_RDONLY, 0);
+    if (l->fd < 0) return 0;
+    if (!mc_mapear(l) || l->cab->magico != MC_MAGICO || l->cab->tam_elem != tam_elem) {
+        if (l->cab) munmap((void *)l->cab, l->bytes);
+        close(l->fd);
+        l->cab = NULL;
+        return 0;
+    }
+    return 1;
+}
+
+/* Espera o escritor sair do meio e devolve o numero de sequencia da leitura */
+static inline uint64_t mc_ler_inicio(LeitorMc *l) {
+    for (;;) {
+        uint64_t seq = atomic_load_explicit(&l->cab->seq, memory_order_acquire);
+        if (seq & 1) { sched_yield(); continue; }
+        if (atomic_load_explicit(&l->cab->capacidade, memory_order_relaxed) > l->capacidade) mc_mapear(l);
+        return seq;
+    }
+}
+
+/* Elementos visiveis nesta leitura (limitados ao que esta mapeado) */
+static inline size_t mc_tamanho(const LeitorMc *l) {
+    size_t n = (size_t)atomic_load_explicit(&l->cab->tamanho, memory_order_relaxed);
+    return n < l->capacidade ? n : l->capacidade;
+}
+
+static inline const void *mc_itens(const LeitorMc *l) { return l->cab->dados; }
+
+/* 1 = o que foi lido desde mc_ler_inicio e uma versao inteira; 0 = refazer */
+static inline int mc_ler_fim(LeitorMc *l, uint64_t seq) {
+    atomic_thread_fence(memory_order_acquire);
+    if (atomic_load_explicit(&l->cab->seq, memory_order_relaxed) == seq) return 1;
+    l->repeticoes++;
+    return 0;
+}
+
+static inline int mc_escritor_ativo(const LeitorMc *l) { return atomic_load(&l->cab->ativo); }
+
+static inline void mc_fechar(LeitorMc *l) {
+    if (!l->cab) return;
+    munmap((void *)l->cab, l->bytes);
+    close(l->fd);
+    l->cab = NULL;
+}
+
+#endif /* __unix__ || __APPLE__ */
+#endif /* MEMORIA_COMPARTILHADA_H */
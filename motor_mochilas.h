@@ -0,0 +1,745 @@
+/*
+ * motor_mochilas.h
+ *
+ * Motor com uma mochila por jogador (dezenas de milhares no mesmo processo).
+ *  - as mochilas sao distribuidas em MOTOR_SHARDS shards pelo hash do id do
+ *    jogador; cada shard tem a propria trava, tabela e arena, entao threads
+ *    que mexem em jogadores de shards diferentes nao disputam nada
+ *  - tabela por shard com enderecamento aberto (sondagem linear) de id -> mochila
+ *  - cabecalhos de mochila vem de uma arena por shard (blocos, sem free
+ *    individual; mochila esvaziada continua reservada para o mesmo jogador)
+ *  - itens de cada mochila num VetorCrescente (vetor_crescente.h)
+ *  - mesmas operacoes dos niveis: inserir, remover, buscar, ordenar, listar
+ *  - busca global (quais mochilas tem o item X) dividida por shard num pool
+ *    de threads, com os achados entregues em lotes enquanto a varredura segue
+ *  - armazenamento frio: mochilas ociosas sao compactadas (nomes ordenados
+ *    com front coding, tipos num dicionario limitado do shard, numeros em
+ *    varint) e descompactadas sozinhas no primeiro acesso
+ *
+ * Todas as funcoes motor_* podem ser chamadas de varias threads ao mesmo tempo.
+ */
+#ifndef MOTOR_MOCHILAS_H
+#define MOTOR_MOCHILAS_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "vetor_crescente.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#define MOTOR_COM_TRAVAS 1
+#endif
+
+#define MOTOR_SHARDS 64            /* potencia de 2 */
+#define MOTOR_TABELA_INICIAL 64    /* posicoes por shard, potencia de 2 */
+#define MOTOR_ARENA_BLOCO 256      /* mochilas por bloco da arena */
+#define MOTOR_TAM_NOME 30
+#define MOTOR_TAM_TIPO 20
+#define MOTOR_IDADE_FRIA 4096      /* operacoes do shard sem tocar a mochila ate ela ficar fria */
+#define MOTOR_TIPOS_MAX 64         /* tipos no dicionario de cada shard; alem disso o tipo vai por extenso */
+
+typedef struct {
+    char nome[MOTOR_TAM_NOME];
+    char tipo[MOTOR_TAM_TIPO];
+    int quantidade;
+    int prioridade;
+} ItemMotor;
+
+typedef enum { MOTOR_POR_NOME = 1, MOTOR_POR_TIPO, MOTOR_POR_PRIORIDADE } CriterioMotor;
+
+typedef char TipoMotor[MOTOR_TAM_TIPO];
+
+typedef struct {
+    uint64_t jogador;
+    VetorCrescente itens; /* de ItemMotor; vazio enquanto a mochila esta fria */
+    unsigned char *fria;  /* registros compactados (NULL = mochila quente) */
+    size_t fria_bytes, fria_itens;
+    size_t ultimo_uso;    /* 'operacoes' do shard no ultimo acesso */
+} MochilaJogador;
+
+typedef struct BlocoArena {
+    struct BlocoArena *anterior;
+    size_t usados;
+    MochilaJogador mochilas[MOTOR_ARENA_BLOCO];
+} BlocoArena;
+
+typedef struct {
+#ifdef MOTOR_COM_TRAVAS
+    pthread_mutex_t trava;
+#endif
+    MochilaJogador **tabela; /* NULL = posicao livre */
+    size_t capacidade;
+    size_t jogadores;
+    BlocoArena *arena;
+    size_t operacoes;
+    VetorCrescente tipos; /* dicionario das mochilas frias: id -> TipoMotor (ate MOTOR_TIPOS_MAX) */
+    size_t congeladas, descongeladas;
+} ShardMotor;
+
+/* Um shard por linha de cache: travas vizinhas nao disputam a mesma linha */
+typedef struct {
+    _Alignas(64) ShardMotor s;
+} ShardAlinhado;
+
+typedef struct {
+    ShardAlinhado shards[MOTOR_SHARDS];
+} MotorMochilas;
+
+/* Mistura do id (splitmix64): ids sequenciais se espalham pelos shards */
+static inline uint64_t motor_misturar(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+static inline ShardMotor *motor_shard(MotorMochilas *m, uint64_t jogador) {
+    return &m->shards[motor_misturar(jogador) & (MOTOR_SHARDS - 1)].s;
+}
+
+static inline void motor_travar(ShardMotor *s) {
+#ifdef MOTOR_COM_TRAVAS
+    pthread_mutex_lock(&s->trava);
+#endif
+    s->operacoes++;
+}
+
+static inline void motor_destravar(ShardMotor *s) {
+#ifdef MOTOR_COM_TRAVAS
+    pthread_mutex_unlock(&s->trava);
+#else
+    (void)s;
+#endif
+}
+
+/* 1 = ok, 0 = sem memoria */
+static inline int motor_init(MotorMochilas *m) {
+    for (size_t i = 0; i < MOTOR_SHARDS; i++) {
+        ShardMotor *s = &m->shards[i].s;
+#ifdef MOTOR_COM_TRAVAS
+        pthread_mutex_init(&s->trava, NULL);
+#endif
+        s->capacidade = MOTOR_TABELA_INICIAL;
+        s->tabela = calloc(s->capacidade, sizeof *s->tabela);
+        s->jogadores = 0;
+        s->arena = NULL;
+        s->operacoes = 0;
+        vc_init(&s->tipos, sizeof(TipoMotor));
+        s->congeladas = s->descongeladas = 0;
+        if (!s->tabela) {
+            /* desfaz os shards ja prontos: quem chama so libera a estrutura */
+            for (size_t k = 0; k <= i; k++) {
+                ShardMotor *x = &m->shards[k].s;
+                free(x->tabela);
+                x->tabela = NULL;
+#ifdef MOTOR_COM_TRAVAS
+                pthread_mutex_destroy(&x->trava);
+#endif
+            }
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static inline void motor_liberar(MotorMochilas *m) {
+    for (size_t i = 0; i < MOTOR_SHARDS; i++) {
+        ShardMotor *s = &m->shards[i].s;
+        while (s->arena) {
+            BlocoArena *b = s->arena;
+            for (size_t k = 0; k < b->usados; k++) {
+                vc_liberar(&b->mochilas[k].itens);
+                free(b->mochilas[k].fria);
+            }
+            s->arena = b->anterior;
+            free(b);
+        }
+        free(s->tabela);
+        s->tabela = NULL;
+        vc_liberar(&s->tipos);
+        s->capacidade = s->jogadores = 0;
+#ifdef MOTOR_COM_TRAVAS
+        pthread_mutex_destroy(&s->trava);
+#endif
+    }
+}
+
+/* Posicao do jogador na tabela, ou a posicao livre onde ele entraria */
+static inline size_t motor_sondar(MochilaJogador **tabela, size_t capacidade, uint64_t jogador) {
+    size_t mascara = capacidade - 1;
+    size_t i = (size_t)(motor_misturar(jogador) >> 6) & mascara; /* bits baixos ja escolheram o shard */
+    while (tabela[i] && tabela[i]->jogador != jogador) i = (i + 1) & mascara;
+    return i;
+}
+
+static inline int motor_crescer_tabela(ShardMotor *s) {
+    if (s->capacidade > SIZE_MAX / 2 / sizeof *s->tabela) return 0;
+    size_t nova_cap = s->capacidade * 2;
+    MochilaJogador **nova = calloc(nova_cap, sizeof *nova);
+    if (!nova) return 0;
+    for (size_t i = 0; i < s->capacidade; i++)
+        if (s->tabela[i]) nova[motor_sondar(nova, nova_cap, s->tabela[i]->jogador)] = s->tabela[i];
+    free(s->tabela);
+    s->tabela = nova;
+    s->capacidade = nova_cap;
+    return 1;
+}
+
+static inline MochilaJogador *motor_achar(ShardMotor *s, uint64_t jogador) {
+    return s->tabela[motor_sondar(s->tabela, s->capacidade, jogador)];
+}
+
+/* Mochila do jogador, criada na arena do shard se ainda nao existe; NULL = sem memoria */
+static inline MochilaJogador *motor_achar_ou_criar(ShardMotor *s, uint64_t jogador) {
+    MochilaJogador *mj = motor_achar(s, jogador);
+    if (mj) return mj;
+    if ((s->jogadores + 1) * 10 > s->capacidade * 7 && !motor_crescer_tabela(s)) return NULL; /* carga <= 70% */
+    if (!s->arena || s->arena->usados == MOTOR_ARENA_BLOCO) {
+        BlocoArena *b = malloc(sizeof *b);
+        if (!b) return NULL;
+        b->anterior = s->arena;
+        b->usados = 0;
+        s->arena = b;
+    }
+    mj = &s->arena->mochilas[s->arena->usados++];
+    mj->jogador = jogador;
+    vc_init(&mj->itens, sizeof(ItemMotor));
+    mj->fria = NULL;
+    mj->fria_bytes = mj->fria_itens = 0;
+    mj->ultimo_uso = s->operacoes;
+    s->tabela[motor_sondar(s->tabela, s->capacidade, jogador)] = mj;
+    s->jogadores++;
+    return mj;
+}
+
+/* ---------------- Armazenamento frio ---------------- */
+
+/*
+ * Formato de uma mochila fria: um registro por item, em ordem de nome
+ *   varint posicao original | prefixo comum com o nome anterior (1 byte) |
+ *   tamanho do sufixo (1 byte) | sufixo | tipo |
+ *   varint zigzag quantidade | varint zigzag prioridade
+ * tipo = id do dicionario + 1 (1 byte), ou 0 + tamanho (1 byte) + texto
+ * quando o dicionario do shard esta cheio (tipos livres vindos da rede nao
+ * fazem o dicionario crescer sem limite).
+ * A posicao original devolve a ordem da mochila ao descompactar.
+ */
+#define MOTOR_TIPO_LITERAL 0
+_Static_assert(MOTOR_TIPOS_MAX < 256, "id do tipo + 1 ocupa um byte no registro frio");
+#define MOTOR_FRIA_MAX_REGISTRO (10 + 2 + MOTOR_TAM_NOME + 2 + MOTOR_TAM_TIPO + 5 + 5)
+
+static inline size_t motor_varint_escrever(unsigned char *p, uint64_t v) {
+    size_t n = 0;
+    while (v >= 0x80) { p[n++] = (unsigned char)(v | 0x80); v >>= 7; }
+    p[n++] = (unsigned char)v;
+    return n;
+}
+
+static inline uint64_t motor_varint_ler(const unsigned char **p) {
+    uint64_t v = 0;
+    unsigned desloc = 0;
+    unsigned char b;
+    do { b = *(*p)++; v |= (uint64_t)(b & 0x7F) << desloc; desloc += 7; } while (b & 0x80);
+    return v;
+}
+
+/* Negativos pequenos tambem viram varints curtos */
+static inline uint64_t motor_zigzag(int v) { return ((uint64_t)(int64_t)v << 1) ^ (v < 0 ? UINT64_MAX : 0); }
+static inline int motor_dezigzag(uint64_t z) { return (int)(int64_t)((z >> 1) ^ (0 - (z & 1))); }
+
+/* Tamanho do texto limitado ao buffer (o item pode vir sem '\0') */
+static inline size_t motor_tam_texto(const char *t, size_t max) {
+    size_t n = 0;
+    while (n < max - 1 && t[n]) n++;
+    return n;
+}
+
+/*
+ * Id do tipo no dicionario do shard (acrescenta se novo e couber);
+ * VC_NAO_ENCONTRADO = dicionario cheio ou sem memoria (o tipo vai por extenso)
+ */
+static inline size_t motor_tipo_id(ShardMotor *s, const char *tipo, size_t *ultimo) {
+    TipoMotor chave;
+    memset(chave, 0, sizeof chave);
+    memcpy(chave, tipo, motor_tam_texto(tipo, MOTOR_TAM_TIPO));
+    const TipoMotor *t = VC_ITENS(&s->tipos, const TipoMotor);
+    /* itens vizinhos costumam repetir o tipo: tenta o ultimo antes da varredura (poucos tipos) */
+    if (*ultimo < s->tipos.tamanho && memcmp(t[*ultimo], chave, sizeof chave) == 0) return *ultimo;
+    for (size_t i = 0; i < s->tipos.tamanho; i++)
+        if (t[i][0] == chave[0] && memcmp(t[i], chave, sizeof chave) == 0) return *ultimo = i;
+    if (s->tipos.tamanho >= MOTOR_TIPOS_MAX || !vc_inserir(&s->tipos, chave)) return VC_NAO_ENCONTRADO;
+    return *ultimo = s->tipos.tamanho - 1;
+}
+
+static inline int motor_comparar_nome_ptr(const void *a, const void *b) {
+    return strncmp((*(const ItemMotor *const *)a)->nome, (*(const ItemMotor *const *)b)->nome, MOTOR_TAM_NOME);
+}
+
+/* Compacta a mochila (chamador com a trava do shard); 1 = ficou fria */
+static inline int motor_congelar(ShardMotor *s, MochilaJogador *mj) {
+    size_t n = mj->itens.tamanho;
+    if (mj->fria || n == 0) return 0;
+    const ItemMotor *it = VC_ITENS(&mj->itens, const ItemMotor);
+    const ItemMotor **ordem = malloc(n * sizeof *ordem);
+    if (!ordem) return 0;
+    for (size_t i = 0; i < n; i++) ordem[i] = &it[i];
+    qsort(ordem, n, sizeof *ordem, motor_comparar_nome_ptr);
+
+    VetorCrescente bytes;
+    vc_init(&bytes, 1);
+    const char *anterior = "";
+    size_t ultimo_tipo = 0;
+    int ok = 1;
+    for (size_t i = 0; i < n; i++) {
+        const ItemMotor *x = ordem[i];
+        if (!vc_garantir(&bytes, bytes.tamanho + MOTOR_FRIA_MAX_REGISTRO)) { ok = 0; break; }
+        size_t tipo = motor_tipo_id(s, x->tipo, &ultimo_tipo);
+        unsigned char *ini = (unsigned char *)bytes.dados + bytes.tamanho, *p = ini;
+        size_t tam = motor_tam_texto(x->nome, MOTOR_TAM_NOME), prefixo = 0;
+        while (prefixo < tam && anterior[prefixo] == x->nome[prefixo]) prefixo++;
+        p += motor_varint_escrever(p, (uint64_t)(x - it));
+        *p++ = (unsigned char)prefixo;
+        *p++ = (unsigned char)(tam - prefixo);
+        memcpy(p, x->nome + prefixo, tam - prefixo);
+        p += tam - prefixo;
+        if (tipo != VC_NAO_ENCONTRADO) *p++ = (unsigned char)(tipo + 1);
+        else {
+            size_t tam_tipo = motor_tam_texto(x->tipo, MOTOR_TAM_TIPO);
+            *p++ = MOTOR_TIPO_LITERAL;
+            *p++ = (unsigned char)tam_tipo;
+            memcpy(p, x->tipo, tam_tipo);
+            p += tam_tipo;
+        }
+        p += motor_varint_escrever(p, motor_zigzag(x->quantidade));
+        p += motor_varint_escrever(p, motor_zigzag(x->prioridade));
+        bytes.tamanho += (size_t)(p - ini);
+        anterior = x->nome;
+    }
+    free(ordem);
+    if (!ok) { vc_liberar(&bytes); return 0; }
+    mj->fria = vc_encolher(bytes.dados, &bytes.capacidade, bytes.tamanho, 1, 1);
+    mj->fria_bytes = bytes.tamanho;
+    mj->fria_itens = n;
+    vc_liberar(&mj->itens);
+    s->congeladas++;
+    return 1;
+}
+
+/*
+ * Le a posicao e o nome do registro em p. 'nome' guarda o nome do registro
+ * anterior (front coding: comeca vazio) e sai com o deste. Devolve o inicio
+ * dos campos restantes.
+ */
+static inline const unsigned char *motor_fria_nome(const unsigned char *p, char nome[MOTOR_TAM_NOME], size_t *pos) {
+    *pos = (size_t)motor_varint_ler(&p);
+    size_t prefixo = *p++, sufixo = *p++;
+    memcpy(nome + prefixo, p, sufixo);
+    nome[prefixo + sufixo] = '\0';
+    return p + sufixo;
+}
+
+/* Monta *item (bytes apos o '\0' zerados) com o nome lido e os campos restantes; devolve o proximo registro */
+static inline const unsigned char *motor_fria_campos(const unsigned char *p, const ShardMotor *s, const char *nome, ItemMotor *item) {
+    memset(item, 0, sizeof *item);
+    memcpy(item->nome, nome, strlen(nome));
+    unsigned tipo = *p++;
+    if (tipo != MOTOR_TIPO_LITERAL) memcpy(item->tipo, VC_ITENS(&s->tipos, const TipoMotor)[tipo - 1], sizeof(TipoMotor));
+    else { size_t tam = *p++; memcpy(item->tipo, p, tam); p += tam; }
+    item->quantidade = motor_dezigzag(motor_varint_ler(&p));
+    item->prioridade = motor_dezigzag(motor_varint_ler(&p));
+    return p;
+}
+
+/* Pula os campos restantes (tipo e dois varints) sem decodificar */
+static inline const unsigned char *motor_fria_pular(const unsigned char *p) {
+    p += *p == MOTOR_TIPO_LITERAL ? 2 + (size_t)p[1] : 1;
+    for (int k = 0; k < 2; k++) while (*p++ & 0x80) {}
+    return p;
+}
+
+/* Volta a mochila para o vetor de itens na ordem original; 0 = sem memoria (continua fria) */
+static inline int motor_descongelar(ShardMotor *s, MochilaJogador *mj) {
+    if (!mj->fria) return 1;
+    ItemMotor *it = malloc(mj->fria_itens * sizeof(ItemMotor)); /* capacidade exata: cabia antes */
+    if (!it) return 0;
+    char nome[MOTOR_TAM_NOME] = "";
+    const unsigned char *p = mj->fria;
+    for (size_t i = 0; i < mj->fria_itens; i++) {
+        size_t pos;
+        p = motor_fria_nome(p, nome, &pos);
+        p = motor_fria_campos(p, s, nome, &it[pos]);
+    }
+    mj->itens.dados = it;
+    mj->itens.tamanho = mj->itens.capacidade = mj->fria_itens;
+    free(mj->fria);
+    mj->fria = NULL;
+    mj->fria_bytes = mj->fria_itens = 0;
+    s->descongeladas++;
+    return 1;
+}
+
+/* Mochila pronta para uso (descompacta se fria) e marcada como usada; NULL = inexistente ou sem memoria */
+static inline MochilaJogador *motor_usar(ShardMotor *s, MochilaJogador *mj) {
+    if (!mj) return NULL;
+    mj->ultimo_uso = s->operacoes;
+    return motor_descongelar(s, mj) ? mj : NULL;
+}
+
+static inline size_t motor_posicao(const MochilaJogador *mj, const char *nome) {
+    const ItemMotor *it = VC_ITENS(&mj->itens, const ItemMotor);
+    for (size_t i = 0; i < mj->itens.tamanho; i++)
+        if (strcmp(it[i].nome, nome) == 0) return i;
+    return VC_NAO_ENCONTRADO;
+}
+
+/* 1 = ok, 0 = sem memoria */
+static inline int motor_inserir(MotorMochilas *m, uint64_t jogador, const ItemMotor *item) {
+    ShardMotor *s = motor_shard(m, jogador);
+    motor_travar(s);
+    MochilaJogador *mj = motor_usar(s, motor_achar_ou_criar(s, jogador));
+    int ok = mj && vc_inserir(&mj->itens, item);
+    motor_destravar(s);
+    return ok;
+}
+
+/* 1 = removido, 0 = jogador ou item inexistente */
+static inline int motor_remover(MotorMochilas *m, uint64_t jogador, const char *nome) {
+    ShardMotor *s = motor_shard(m, jogador);
+    motor_travar(s);
+    MochilaJogador *mj = motor_usar(s, motor_achar(s, jogador));
+    size_t idx = mj ? motor_posicao(mj, nome) : VC_NAO_ENCONTRADO;
+    if (idx != VC_NAO_ENCONTRADO) vc_remover(&mj->itens, idx);
+    motor_destravar(s);
+    return idx != VC_NAO_ENCONTRADO;
+}
+
+/* 1 = encontrado (copiado para *saida se nao for NULL) */
+static inline int motor_buscar(MotorMochilas *m, uint64_t jogador, const char *nome, ItemMotor *saida) {
+    ShardMotor *s = motor_shard(m, jogador);
+    motor_travar(s);
+    MochilaJogador *mj = motor_usar(s, motor_achar(s, jogador));
+    size_t idx = mj ? motor_posicao(mj, nome) : VC_NAO_ENCONTRADO;
+    if (idx != VC_NAO_ENCONTRADO && saida) *saida = VC_ITENS(&mj->itens, ItemMotor)[idx];
+    motor_destravar(s);
+    return idx != VC_NAO_ENCONTRADO;
+}
+
+static inline int motor_comparar(const ItemMotor *a, const ItemMotor *b, CriterioMotor crit) {
+    if (crit == MOTOR_POR_NOME) return strcmp(a->nome, b->nome);
+    if (crit == MOTOR_POR_TIPO) return strcmp(a->tipo, b->tipo);
+    return (a->prioridade > b->prioridade) - (a->prioridade < b->prioridade);
+}
+
+/* Insertion sort estavel (mochilas de jogador sao pequenas); devolve comparacoes */
+static inline long long motor_ordenar(MotorMochilas *m, uint64_t jogador, CriterioMotor crit) {
+    ShardMotor *s = motor_shard(m, jogador);
+    long long comparacoes = 0;
+    motor_travar(s);
+    MochilaJogador *mj = motor_usar(s, motor_achar(s, jogador));
+    if (mj) {
+        ItemMotor *it = VC_ITENS(&mj->itens, ItemMotor);
+        for (size_t i = 1; i < mj->itens.tamanho; i++) {
+            ItemMotor chave = it[i];
+            size_t j = i;
+            while (j > 0 && (comparacoes++, motor_comparar(&it[j - 1], &chave, crit) > 0)) {
+                it[j] = it[j - 1];
+                j--;
+            }
+            it[j] = chave;
+        }
+    }
+    motor_destravar(s);
+    return comparacoes;
+}
+
+/*
+ * Copia ate 'max' itens do jogador para 'destino' (foto consistente, tirada
+ * sob a trava do shard) e devolve quantos itens a mochila tem.
+ */
+static inline size_t motor_listar(MotorMochilas *m, uint64_t jogador, void *destino, size_t max) {
+    ShardMotor *s = motor_shard(m, jogador);
+    motor_travar(s);
+    MochilaJogador *mj = motor_usar(s, motor_achar(s, jogador));
+    size_t n = mj ? mj->itens.tamanho : 0;
+    if (n && max) memcpy(destino, mj->itens.dados, (n < max ? n : max) * sizeof(ItemMotor));
+    motor_destravar(s);
+    return n;
+}
+
+typedef struct {
+    size_t jogadores, itens, operacoes;
+    size_t shard_min, shard_max; /* jogadores no shard menos/mais cheio */
+    size_t frias, itens_frios;   /* mochilas compactadas e itens dentro delas */
+    size_t bytes_quentes;        /* capacidade reservada dos vetores de itens */
+    size_t bytes_frios;          /* registros compactados */
+    size_t tipos;                /* entradas nos dicionarios de tipos */
+    size_t congeladas, descongeladas;
+} EstatisticasMotor;
+
+static inline EstatisticasMotor motor_estatisticas(MotorMochilas *m) {
+    EstatisticasMotor e;
+    memset(&e, 0, sizeof e);
+    e.shard_min = SIZE_MAX;
+    for (size_t i = 0; i < MOTOR_SHARDS; i++) {
+        ShardMotor *s = &m->shards[i].s;
+#ifdef MOTOR_COM_TRAVAS
+        pthread_mutex_lock(&s->trava);
+#endif
+        e.jogadores += s->jogadores;
+        e.operacoes += s->operacoes;
+        for (BlocoArena *b = s->arena; b; b = b->anterior)
+            for (size_t k = 0; k < b->usados; k++) {
+                const MochilaJogador *mj = &b->mochilas[k];
+                e.itens += mj->itens.tamanho + mj->fria_itens;
+                e.bytes_quentes += mj->itens.capacidade * sizeof(ItemMotor);
+                if (mj->fria) { e.frias++; e.itens_frios += mj->fria_itens; e.bytes_frios += mj->fria_bytes; }
+            }
+        e.tipos += s->tipos.tamanho;
+        e.congeladas += s->congeladas;
+        e.descongeladas += s->descongeladas;
+        if (s->jogadores < e.shard_min) e.shard_min = s->jogadores;
+        if (s->jogadores > e.shard_max) e.shard_max = s->jogadores;
+        motor_destravar(s);
+    }
+    return e;
+}
+
+/* ---------------- Pool de threads (tarefas sobre indices 0..n-1) ---------------- */
+
+#define MOTOR_POOL_MAX 32
+
+typedef struct {
+#ifdef MOTOR_COM_TRAVAS
+    pthread_t threads[MOTOR_POOL_MAX];
+    pthread_mutex_t trava;
+    pthread_cond_t tem_tarefa, terminou;
+#endif
+    int nthreads;                      /* 0 = executa na thread que chamou */
+    void (*tarefa)(size_t indice, void *arg);
+    void *arg;
+    size_t total;
+    size_t proximo;                    /* proximo indice livre (sob a trava) */
+    int ativos;                        /* trabalhadores ainda na tarefa atual */
+    unsigned geracao;                  /* muda a cada tarefa publicada */
+    int encerrar;
+} PoolMotor;
+
+/* Pega o proximo indice da tarefa atual; 0 = acabou */
+static inline int motor_pool_pegar(PoolMotor *p, size_t *indice) {
+#ifdef MOTOR_COM_TRAVAS
+    pthread_mutex_lock(&p->trava);
+#endif
+    int tem = p->proximo < p->total;
+    if (tem) *indice = p->proximo++;
+#ifdef MOTOR_COM_TRAVAS
+    pthread_mutex_unlock(&p->trava);
+#endif
+    return tem;
+}
+
+#ifdef MOTOR_COM_TRAVAS
+static inline void *motor_pool_trabalhador(void *arg) {
+    PoolMotor *p = arg;
+    unsigned vista = 0;
+    for (;;) {
+        pthread_mutex_lock(&p->trava);
+        while (!p->encerrar && p->geracao == vista) pthread_cond_wait(&p->tem_tarefa, &p->trava);
+        if (p->encerrar) { pthread_mutex_unlock(&p->trava); return NULL; }
+        vista = p->geracao;
+        pthread_mutex_unlock(&p->trava);
+        size_t i;
+        while (motor_pool_pegar(p, &i)) p->tarefa(i, p->arg);
+        pthread_mutex_lock(&p->trava);
+        if (--p->ativos == 0) pthread_cond_signal(&p->terminou);
+        pthread_mutex_unlock(&p->trava);
+    }
+}
+#endif
+
+/* Cria ate 'nthreads' trabalhadores (menos se o SO recusar; 0 sem pthreads) */
+static inline void motor_pool_init(PoolMotor *p, int nthreads) {
+    p->nthreads = 0;
+    p->total = p->proximo = 0;
+    p->ativos = 0;
+    p->geracao = 0;
+    p->encerrar = 0;
+#ifdef MOTOR_COM_TRAVAS
+    pthread_mutex_init(&p->trava, NULL);
+    pthread_cond_init(&p->tem_tarefa, NULL);
+    pthread_cond_init(&p->terminou, NULL);
+    if (nthreads > MOTOR_POOL_MAX) nthreads = MOTOR_POOL_MAX;
+    while (p->nthreads < nthreads && pthread_create(&p->threads[p->nthreads], NULL, motor_pool_trabalhador, p) == 0)
+        p->nthreads++;
+#else
+    (void)nthreads;
+#endif
+}
+
+/* Roda tarefa(i, arg) para i em [0, total) e espera todas terminarem */
+static inline void motor_pool_executar(PoolMotor *p, void (*tarefa)(size_t, void *), void *arg, size_t total) {
+    p->tarefa = tarefa;
+    p->arg = arg;
+    p->total = total;
+    p->proximo = 0;
+    if (p->nthreads == 0) {
+        size_t i;
+        while (motor_pool_pegar(p, &i)) tarefa(i, arg);
+        return;
+    }
+#ifdef MOTOR_COM_TRAVAS
+    pthread_mutex_lock(&p->trava);
+    p->ativos = p->nthreads;
+    p->geracao++;
+    pthread_cond_broadcast(&p->tem_tarefa);
+    while (p->ativos > 0) pthread_cond_wait(&p->terminou, &p->trava);
+    pthread_mutex_unlock(&p->trava);
+#endif
+}
+
+static inline void motor_pool_liberar(PoolMotor *p) {
+#ifdef MOTOR_COM_TRAVAS
+    pthread_mutex_lock(&p->trava);
+    p->encerrar = 1;
+    pthread_cond_broadcast(&p->tem_tarefa);
+    pthread_mutex_unlock(&p->trava);
+    for (int i = 0; i < p->nthreads; i++) pthread_join(p->threads[i], NULL);
+    pthread_mutex_destroy(&p->trava);
+    pthread_cond_destroy(&p->tem_tarefa);
+    pthread_cond_destroy(&p->terminou);
+#endif
+    p->nthreads = 0;
+}
+
+/* ---------------- Busca global: quais mochilas tem o item ---------------- */
+
+#define MOTOR_LOTE_GLOBAL 64 /* achados entregues de uma vez */
+
+/* Recebe os achados em lotes, um lote por vez (nao precisa ser thread-safe) */
+typedef void (*EntregaGlobal)(const uint64_t jogadores[], const ItemMotor itens[], size_t n, void *ctx);
+
+typedef struct {
+    MotorMochilas *m;
+    const char *nome;
+    size_t tam_nome;
+    EntregaGlobal entregar;
+    void *ctx;
+    size_t achados;
+#ifdef MOTOR_COM_TRAVAS
+    pthread_mutex_t saida; /* serializa as entregas */
+#endif
+} BuscaGlobal;
+
+static inline void motor_global_entregar(BuscaGlobal *b, const uint64_t jogadores[], const ItemMotor itens[], size_t n) {
+    if (n == 0) return;
+#ifdef MOTOR_COM_TRAVAS
+    pthread_mutex_lock(&b->saida);
+#endif
+    b->achados += n;
+    if (b->entregar) b->entregar(jogadores, itens, n, b->ctx);
+#ifdef MOTOR_COM_TRAVAS
+    pthread_mutex_unlock(&b->saida);
+#endif
+}
+
+/* Varre um shard inteiro; cada lote cheio ja sai para o chamador (resultado em fluxo) */
+static inline void motor_global_shard(size_t indice, void *arg) {
+    BuscaGlobal *b = arg;
+    ShardMotor *s = &b->m->shards[indice].s;
+    uint64_t jogadores[MOTOR_LOTE_GLOBAL];
+    ItemMotor itens[MOTOR_LOTE_GLOBAL];
+    size_t n = 0;
+    motor_travar(s);
+    for (BlocoArena *bl = s->arena; bl; bl = bl->anterior)
+        for (size_t k = 0; k < bl->usados; k++) {
+            const MochilaJogador *mj = &bl->mochilas[k];
+            if (mj->fria) {
+                /* decodifica sem descompactar (a varredura nao conta como uso); nomes
+                   em ordem: o primeiro maior que o procurado encerra a mochila */
+                char nome[MOTOR_TAM_NOME] = "";
+                const unsigned char *p = mj->fria;
+                for (size_t i = 0; i < mj->fria_itens; i++) {
+                    size_t pos;
+                    p = motor_fria_nome(p, nome, &pos);
+                    int cmp = strcmp(nome, b->nome);
+                    if (cmp > 0) break;
+                    if (cmp < 0) { p = motor_fria_pular(p); continue; }
+                    p = motor_fria_campos(p, s, nome, &itens[n]);
+                    jogadores[n++] = mj->jogador;
+                    if (n == MOTOR_LOTE_GLOBAL) { motor_global_entregar(b, jogadores, itens, n); n = 0; }
+                }
+                continue;
+            }
+            const ItemMotor *it = VC_ITENS(&mj->itens, const ItemMotor);
+            for (size_t i = 0; i < mj->itens.tamanho; i++) {
+                /* primeiro byte antes do memcmp: a maioria dos nomes sai aqui */
+                if (it[i].nome[0] != b->nome[0] || memcmp(it[i].nome, b->nome, b->tam_nome + 1) != 0) continue;
+                jogadores[n] = mj->jogador;
+                itens[n++] = it[i];
+                if (n == MOTOR_LOTE_GLOBAL) { motor_global_entregar(b, jogadores, itens, n); n = 0; }
+            }
+        }
+    motor_destravar(s);
+    motor_global_entregar(b, jogadores, itens, n);
+}
+
+/*
+ * Todas as mochilas com um item chamado 'nome'. Os shards sao divididos
+ * entre os trabalhadores do pool; cada um trava so o shard que esta varrendo,
+ * entao o resto do motor continua atendendo. Devolve o total de achados.
+ */
+static inline size_t motor_buscar_global(MotorMochilas *m, PoolMotor *pool, const char *nome, EntregaGlobal entregar, void *ctx) {
+    BuscaGlobal b = { m, nome, strlen(nome), entregar, ctx, 0
+#ifdef MOTOR_COM_TRAVAS
+        , PTHREAD_MUTEX_INITIALIZER
+#endif
+    };
+    if (b.tam_nome >= MOTOR_TAM_NOME) return 0;
+    motor_pool_executar(pool, motor_global_shard, &b, MOTOR_SHARDS);
+#ifdef MOTOR_COM_TRAVAS
+    pthread_mutex_destroy(&b.saida);
+#endif
+    return b.achados;
+}
+
+/* ---------------- Compactacao das mochilas ociosas ---------------- */
+
+typedef struct {
+    MotorMochilas *m;
+    size_t idade;
+    size_t compactadas[MOTOR_SHARDS]; /* uma posicao por shard: sem disputa entre trabalhadores */
+} CompactacaoMotor;
+
+static inline void motor_compactar_shard(size_t indice, void *arg) {
+    CompactacaoMotor *c = arg;
+    ShardMotor *s = &c->m->shards[indice].s;
+#ifdef MOTOR_COM_TRAVAS
+    pthread_mutex_lock(&s->trava); /* sem motor_travar: compactar nao conta como operacao */
+#endif
+    for (BlocoArena *b = s->arena; b; b = b->anterior)
+        for (size_t k = 0; k < b->usados; k++) {
+            MochilaJogador *mj = &b->mochilas[k];
+            if (!mj->fria && s->operacoes - mj->ultimo_uso >= c->idade && motor_congelar(s, mj)) c->compactadas[indice]++;
+        }
+    motor_destravar(s);
+}
+
+/*
+ * Compacta as mochilas sem acesso ha pelo menos 'idade' operacoes do seu
+ * shard (0 = todas). Com pool os shards sao divididos entre os
+ * trabalhadores; pool NULL roda na thread que chamou. Devolve quantas
+ * mochilas ficaram frias.
+ */
+static inline size_t motor_compactar(MotorMochilas *m, PoolMotor *pool, size_t idade) {
+    CompactacaoMotor c;
+    c.m = m;
+    c.idade = idade;
+    memset(c.compactadas, 0, sizeof c.compactadas);
+    if (pool) motor_pool_executar(pool, motor_compactar_shard, &c, MOTOR_SHARDS);
+    else for (size_t i = 0; i < MOTOR_SHARDS; i++) motor_compactar_shard(i, &c);
+    size_t total = 0;
+    for (size_t i = 0; i < MOTOR_SHARDS; i++) total += c.compactadas[i];
+    return total;
+}
+
+#endif /* MOTOR_MOCHILAS_H */
@@ -0,0 +1,146 @@
+/*
+ * selecao_parcial.h
+ *
+ * "Mostrar os N primeiros" sem ordenar o vetor inteiro.
+ *  - sp_selecionar (nth_element): poe na posicao k o elemento que estaria
+ *    la no vetor ordenado, com os menores antes e os maiores depois.
+ *    Introselect: quickselect (mediana de tres, particao em tres faixas),
+ *    O(n) esperado; se passar de 2*log2(n) particoes, cai para selecao
+ *    por heap e o pior caso fica O(n log n)
+ *  - sp_ordenar_parcial: os N menores ordenados em [0, N), o resto em
+ *    qualquer ordem. O(n + N log N)
+ *
+ * Generico como o qsort (tam_elem + comparador), com um contexto para o
+ * criterio e o contador de comparacoes do chamador:
+ *   long long comps = 0;
+ *   sp_ordenar_parcial(itens, n, sizeof(Item), 10, comparar_item, &crit, &comps);
+ */
+#ifndef SELECAO_PARCIAL_H
+#define SELECAO_PARCIAL_H
+
+#include <stddef.h>
+#include <string.h>
+
+typedef int (*ComparadorSp)(const void *a, const void *b, void *ctx);
+
+typedef struct {
+    unsigned char *base;
+    size_t tam;
+    ComparadorSp cmp;
+    void *ctx;
+    long long *comparacoes;
+} VetorSp;
+
+static inline void *sp_em(const VetorSp *v, size_t i) { return v->base + i * v->tam; }
+
+static inline int sp_comparar(const VetorSp *v, size_t i, size_t j) {
+    (*v->comparacoes)++;
+    return v->cmp(sp_em(v, i), sp_em(v, j), v->ctx);
+}
+
+static inline void sp_trocar(const VetorSp *v, size_t i, size_t j) {
+    if (i == j) return;
+    unsigned char *a = sp_em(v, i), *b = sp_em(v, j), tmp[64];
+    for (size_t feito = 0; feito < v->tam; feito += sizeof tmp) {
+        size_t k = v->tam - feito < sizeof tmp ? v->tam - feito : sizeof tmp;
+        memcpy(tmp, a + feito, k);
+        memcpy(a + feito, b + feito, k);
+        memcpy(b + feito, tmp, k);
+    }
+}
+
+/* ---------------- Heap (maximo no topo) sobre [ini, ini + n) ---------------- */
+
+static inline void sp_descer(const VetorSp *v, size_t ini, size_t n, size_t i) {
+    for (;;) {
+        size_t maior = i, e = 2 * i + 1, d = e + 1;
+        if (e < n && sp_comparar(v, ini + e, ini + maior) > 0) maior = e;
+        if (d < n && sp_comparar(v, ini + d, ini + maior) > 0) maior = d;
+        if (maior == i) return;
+        sp_trocar(v, ini + i, ini + maior);
+        i = maior;
+    }
+}
+
+static inline void sp_heapificar(const VetorSp *v, size_t ini, size_t n) {
+    for (size_t i = n / 2; i-- > 0;) sp_descer(v, ini, n, i);
+}
+
+/*
+ * Selecao por heap em [ini, fim): os m = k - ini + 1 menores ficam em
+ * [ini, k] com o maior deles em k. O(n log m)
+ */
+static inline void sp_selecionar_heap(const VetorSp *v, size_t ini, size_t fim, size_t k) {
+    size_t m = k - ini + 1;
+    sp_heapificar(v, ini, m);
+    for (size_t i = k + 1; i < fim; i++)
+        if (sp_comparar(v, i, ini) < 0) { sp_trocar(v, i, ini); sp_descer(v, ini, m, 0); }
+    sp_trocar(v, ini, k); /* o maior dos m menores vai para k */
+}
+
+/* Ordena [ini, ini + n) com heapsort (in-place, O(n log n) garantido) */
+static inline void sp_heapsort(const VetorSp *v, size_t ini, size_t n) {
+    sp_heapificar(v, ini, n);
+    for (size_t fim = n; fim > 1; fim--) {
+        sp_trocar(v, ini, ini + fim - 1);
+        sp_descer(v, ini, fim - 1, 0);
+    }
+}
+
+/*
+ * Particao em tres faixas em volta da mediana de tres (uma comparacao por
+ * elemento, o comparador ja diz <, = ou >): [ini, *lt) menores,
+ * [*lt, *gt) iguais ao pivo, [*gt, fim) maiores. Muitas chaves repetidas
+ * (prioridades 1..5) terminam numa passada.
+ */
+static inline void sp_particionar(const VetorSp *v, size_t ini, size_t fim, size_t *lt, size_t *gt) {
+    size_t meio = ini + (fim - ini) / 2, ult = fim - 1;
+    if (sp_comparar(v, meio, ini) < 0) sp_trocar(v, meio, ini);
+    if (sp_comparar(v, ult, ini) < 0) sp_trocar(v, ult, ini);
+    if (sp_comparar(v, ult, meio) < 0) sp_trocar(v, ult, meio);
+    sp_trocar(v, meio, ini); /* pivo no inicio; [l, i) sempre guarda iguais a ele */
+    size_t l = ini, i = ini + 1, g = fim;
+    while (i < g) {
+        int c = sp_comparar(v, i, l);
+        if (c < 0) sp_trocar(v, l++, i++);
+        else if (c > 0) sp_trocar(v, i, --g);
+        else i++;
+    }
+    *lt = l;
+    *gt = g;
+}
+
+static inline void sp_introselect(const VetorSp *v, size_t ini, size_t fim, size_t k) {
+    int limite = 0;
+    for (size_t n = fim - ini; n > 1; n >>= 1) limite += 2;
+    while (fim - ini > 3) {
+        if (limite-- == 0) { sp_selecionar_heap(v, ini, fim, k); return; }
+        size_t lt, gt;
+        sp_particionar(v, ini, fim, &lt, &gt);
+        if (k < lt) fim = lt;
+        else if (k >= gt) ini = gt;
+        else return;
+    }
+    /* ate 3 elementos: insercao */
+    for (size_t i = ini + 1; i < fim; i++)
+        for (size_t j = i; j > ini && sp_comparar(v, j - 1, j) > 0; j--) sp_trocar(v, j - 1, j);
+}
+
+/* nth_element: base[k] vira o k-esimo (0-based) pelo comparador */
+static inline void sp_selecionar(void *base, size_t n, size_t tam, size_t k, ComparadorSp cmp, void *ctx, long long *comparacoes) {
+    if (k >= n) return;
+    VetorSp v = { base, tam, cmp, ctx, comparacoes };
+    sp_introselect(&v, 0, n, k);
+}
+
+/* Os N menores ordenados em [0, N); N >= n ordena tudo */
+static inline void sp_ordenar_parcial(void *base, size_t n, size_t tam, size_t N, ComparadorSp cmp, void *ctx, long long *comparacoes) {
+    if (N > n) N = n;
+    if (N == 0) return;
+    VetorSp v = { base, tam, cmp, ctx, comparacoes };
+    if (N == n) { sp_heapsort(&v, 0, n); return; }
+    sp_introselect(&v, 0, n, N - 1);
+    sp_heapsort(&v, 0, N - 1); /* base[N-1] ja e o maior dos N */
+}
+
+#endif /* SELECAO_PARCIAL_H */
@@ -0,0 +1,149 @@
+/*
+ * tipos_item.h
+ *
+ * Tipo do item como inteiro: o texto vira id uma vez, na insercao, e as
+ * ordenacoes por tipo comparam inteiros em vez de strcmp.
+ *  - tipos canonicos do jogo (a lista do prompt "arma, municao, cura, etc."):
+ *    hash perfeito (tamanho, primeira e ultima letra) numa tabela de 32
+ *    posicoes e um strcmp para confirmar; ids 0..TIPOS_CANONICOS-1 ja em
+ *    ordem alfabetica
+ *  - qualquer outro texto cai no dicionario dinamico (ids a partir de
+ *    TIPOS_CANONICOS, na ordem de chegada; o dicionario so cresce)
+ *  - tipo_ordem(id) e a posicao alfabetica do tipo entre todos os conhecidos:
+ *    comparar ordens da o mesmo resultado que strcmp nos textos. Um tipo novo
+ *    desloca as ordens seguintes mas nunca inverte duas ja existentes
+ *
+ * Uso:
+ *   item.tipo_id = tipo_id(item.tipo);          // TIPO_SEM_MEMORIA se faltar memoria
+ *   if (tipo_ordem(a.tipo_id) < tipo_ordem(b.tipo_id)) ...
+ */
+#ifndef TIPOS_ITEM_H
+#define TIPOS_ITEM_H
+
+#include <stdint.h>
+#include <string.h>
+#include "vetor_crescente.h"
+
+#define TIPOS_CANONICOS 12
+#define TIPOS_TAM_TEXTO 32 /* >= TAM_TIPO de todos os niveis */
+#define TIPO_SEM_MEMORIA UINT32_MAX
+
+/* Em ordem alfabetica: o id canonico ja e a ordem entre eles */
+static const char *const tipos_canonicos[TIPOS_CANONICOS] = {
+    "arma", "armadura", "chave", "comida", "cura", "equipamento",
+    "explosivo", "ferramenta", "material", "municao", "recurso", "utilidade"
+};
+
+/*
+ * Posicao -> id canonico + 1 (0 = vazia). Multiplicadores achados por busca
+ * exaustiva: os 12 tipos caem em posicoes distintas de
+ * (tamanho + 4 * primeira + ultima) & 31.
+ */
+static const unsigned char tipos_tabela[32] = {
+    [9] = 1, [13] = 2, [22] = 3, [19] = 4, [17] = 5, [14] = 6,
+    [12] = 7, [3] = 8, [8] = 9, [10] = 10, [30] = 11, [2] = 12
+};
+
+static inline unsigned tipos_hash(const char *s, size_t tam) {
+    return (unsigned)(tam + 4u * (unsigned char)s[0] + (unsigned char)s[tam - 1]) & 31u;
+}
+
+/* Id canonico ou -1 (o texto nao e um dos tipos do jogo) */
+static inline int tipo_canonico(const char *s) {
+    size_t tam = strlen(s);
+    if (tam == 0) return -1;
+    int id = tipos_tabela[tipos_hash(s, tam)] - 1;
+    if (id < 0 || strcmp(tipos_canonicos[id], s) != 0) return -1;
+    return id;
+}
+
+/* ---------------- Dicionario dinamico (todos os niveis usam um so) ---------------- */
+
+typedef char TextoTipo[TIPOS_TAM_TEXTO];
+
+typedef struct {
+    VetorCrescente textos;     /* id -> TextoTipo (canonicos e extras) */
+    VetorCrescente ordenados;  /* uint32_t ids em ordem alfabetica */
+    VetorCrescente ordem;      /* id -> posicao em 'ordenados' */
+    int iniciado;
+} DicionarioTipos;
+
+static DicionarioTipos tipos_dic;
+
+static inline const char *tipo_texto(uint32_t id) {
+    return tipos_dic.iniciado ? VC_ITENS(&tipos_dic.textos, const TextoTipo)[id] : tipos_canonicos[id];
+}
+
+/* Antes do primeiro tipo extra so existem os canonicos, ja em ordem */
+static inline uint32_t tipo_ordem(uint32_t id) {
+    return tipos_dic.iniciado ? VC_ITENS(&tipos_dic.ordem, const uint32_t)[id] : id;
+}
+
+/* Tipos conhecidos (canonicos + extras vistos ate agora) */
+static inline size_t tipos_quantidade(void) { return tipos_dic.iniciado ? tipos_dic.textos.tamanho : TIPOS_CANONICOS; }
+
+static inline int tipos_iniciar(void) {
+    if (tipos_dic.iniciado) return 1;
+    vc_init(&tipos_dic.textos, sizeof(TextoTipo));
+    vc_init(&tipos_dic.ordenados, sizeof(uint32_t));
+    vc_init(&tipos_dic.ordem, sizeof(uint32_t));
+    if (!vc_garantir(&tipos_dic.textos, TIPOS_CANONICOS) || !vc_garantir(&tipos_dic.ordenados, TIPOS_CANONICOS)
+        || !vc_garantir(&tipos_dic.ordem, TIPOS_CANONICOS)) return 0;
+    for (uint32_t i = 0; i < TIPOS_CANONICOS; i++) {
+        TextoTipo t = {0};
+        memcpy(t, tipos_canonicos[i], strlen(tipos_canonicos[i]));
+        vc_inserir(&tipos_dic.textos, t);
+        vc_inserir(&tipos_dic.ordenados, &i);
+        vc_inserir(&tipos_dic.ordem, &i);
+    }
+    tipos_dic.iniciado = 1;
+    return 1;
+}
+
+/* Acrescenta um tipo fora do conjunto canonico e refaz as ordens: O(tipos) */
+static inline uint32_t tipos_acrescentar(const char *s, size_t tam, size_t pos) {
+    uint32_t id = (uint32_t)tipos_dic.textos.tamanho;
+    TextoTipo t = {0};
+    memcpy(t, s, tam);
+    if (!vc_garantir(&tipos_dic.textos, id + 1) || !vc_garantir(&tipos_dic.ordenados, id + 1)
+        || !vc_garantir(&tipos_dic.ordem, id + 1)) return TIPO_SEM_MEMORIA;
+    vc_inserir(&tipos_dic.textos, t);
+    uint32_t *ord = VC_ITENS(&tipos_dic.ordenados, uint32_t);
+    memmove(ord + pos + 1, ord + pos, (id - pos) * sizeof(uint32_t));
+    ord[pos] = id;
+    tipos_dic.ordenados.tamanho++;
+    tipos_dic.ordem.tamanho++;
+    uint32_t *ordem = VC_ITENS(&tipos_dic.ordem, uint32_t);
+    for (size_t i = pos; i <= id; i++) ordem[ord[i]] = (uint32_t)i;
+    return id;
+}
+
+/* Id do tipo (acrescenta ao dicionario se for novo); TIPO_SEM_MEMORIA se faltar memoria */
+static inline uint32_t tipo_id(const char *s) {
+    int c = tipo_canonico(s);
+    if (c >= 0) return (uint32_t)c;
+    if (!tipos_iniciar()) return TIPO_SEM_MEMORIA;
+    size_t tam = strlen(s);
+    if (tam >= TIPOS_TAM_TEXTO) tam = TIPOS_TAM_TEXTO - 1;
+    /* busca binaria pela posicao alfabetica entre todos os tipos conhecidos */
+    const uint32_t *ord = VC_ITENS(&tipos_dic.ordenados, const uint32_t);
+    size_t esq = 0, dir = tipos_dic.ordenados.tamanho;
+    while (esq < dir) {
+        size_t meio = esq + (dir - esq) / 2;
+        int cmp = strncmp(tipo_texto(ord[meio]), s, TIPOS_TAM_TEXTO - 1);
+        if (cmp == 0) return ord[meio];
+        if (cmp < 0) esq = meio + 1;
+        else dir = meio;
+    }
+    return tipos_acrescentar(s, tam, esq);
+}
+
+static inline void tipos_liberar(void) {
+    if (!tipos_dic.iniciado) return;
+    vc_liberar(&tipos_dic.textos);
+    vc_liberar(&tipos_dic.ordenados);
+    vc_liberar(&tipos_dic.ordem);
+    tipos_dic.iniciado = 0;
+}
+
+#endif /* TIPOS_ITEM_H */
@@ -0,0 +1,136 @@
+/*
+ * vetor_crescente.h
+ *
+ * Container crescente compartilhado por todos os niveis (substitui os
+ * vetores fixos MAX_ITENS / MOD1_MAX / MOD3_MAX).
+ *  - tamanhos em size_t: o limite e a memoria, nao um #define
+ *  - crescimento com verificacao de overflow (elementos e bytes)
+ *  - fator de crescimento configuravel: -DVC_FATOR_CRESCIMENTO=1.5 na
+ *    compilacao ou o campo 'fator' de cada vetor
+ *  - encolhe com histerese: so quando o uso cai abaixo de 1/VC_ENCOLHER_ABAIXO
+ *    da capacidade, e para o dobro do tamanho (nao oscila entre crescer e
+ *    encolher quando o tamanho fica perto de um limite)
+ *
+ * Uso:
+ *   VetorCrescente v; vc_init(&v, sizeof(Item));
+ *   if (!vc_inserir(&v, &item)) ... memoria insuficiente ...
+ *   VC_ITENS(&v, Item)[i]
+ *   vc_liberar(&v);
+ */
+#ifndef VETOR_CRESCENTE_H
+#define VETOR_CRESCENTE_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef VC_FATOR_CRESCIMENTO
+#define VC_FATOR_CRESCIMENTO 2.0
+#endif
+#define VC_FATOR_MINIMO 1.1
+#define VC_CAPACIDADE_INICIAL 8
+#define VC_ENCOLHER_ABAIXO 4
+
+/* Indice devolvido pelas buscas quando o item nao existe */
+#define VC_NAO_ENCONTRADO ((size_t)-1)
+
+typedef struct {
+    void *dados;
+    size_t tamanho;
+    size_t capacidade;
+    size_t tam_elem;
+    double fator;
+} VetorCrescente;
+
+#define VC_ITENS(v, T) ((T *)(v)->dados)
+
+/* Proxima capacidade >= necessaria seguindo o fator; 0 se nao cabe em size_t */
+static inline size_t vc_proxima_capacidade(size_t atual, size_t necessaria, size_t tam_elem, double fator) {
+    const size_t maximo = SIZE_MAX / tam_elem;
+    if (necessaria > maximo) return 0;
+    if (fator < VC_FATOR_MINIMO) fator = VC_FATOR_MINIMO;
+    size_t cap = atual ? atual : VC_CAPACIDADE_INICIAL;
+    while (cap < necessaria) {
+        double prox = (double)cap * fator;
+        if (prox >= (double)maximo) { cap = maximo; break; }
+        size_t nova = (size_t)prox;
+        cap = nova > cap ? nova : cap + 1;
+    }
+    return cap;
+}
+
+/*
+ * Realoca 'dados' para comportar 'necessaria' elementos. Devolve o novo
+ * ponteiro (e atualiza *capacidade) ou NULL, mantendo o bloco antigo valido.
+ */
+static inline void *vc_crescer(void *dados, size_t *capacidade, size_t necessaria, size_t tam_elem, double fator) {
+    if (*capacidade >= necessaria && dados) return dados;
+    size_t cap = vc_proxima_capacidade(*capacidade, necessaria, tam_elem, fator);
+    if (cap == 0) return NULL;
+    void *novo = realloc(dados, cap * tam_elem);
+    if (!novo) return NULL;
+    *capacidade = cap;
+    return novo;
+}
+
+/* Capacidade apos a politica de encolhimento (igual a atual se nao deve encolher) */
+static inline size_t vc_capacidade_encolhida(size_t tamanho, size_t capacidade) {
+    if (capacidade <= VC_CAPACIDADE_INICIAL || tamanho >= capacidade / VC_ENCOLHER_ABAIXO) return capacidade;
+    size_t alvo = tamanho * 2;
+    return alvo < VC_CAPACIDADE_INICIAL ? VC_CAPACIDADE_INICIAL : alvo;
+}
+
+/*
+ * Libera capacidade ociosa segundo a politica acima ('justo' = 1 ignora a
+ * histerese e encolhe para exatamente 'tamanho', minimo 1). Devolve o novo
+ * ponteiro; se o realloc falhar, o bloco antigo continua valido.
+ */
+static inline void *vc_encolher(void *dados, size_t *capacidade, size_t tamanho, size_t tam_elem, int justo) {
+    size_t cap = justo ? (tamanho ? tamanho : 1) : vc_capacidade_encolhida(tamanho, *capacidade);
+    if (!dados || cap >= *capacidade) return dados;
+    void *novo = realloc(dados, cap * tam_elem);
+    if (!novo) return dados;
+    *capacidade = cap;
+    return novo;
+}
+
+static inline void vc_init(VetorCrescente *v, size_t tam_elem) {
+    v->dados = NULL;
+    v->tamanho = 0;
+    v->capacidade = 0;
+    v->tam_elem = tam_elem;
+    v->fator = VC_FATOR_CRESCIMENTO;
+}
+
+/* 1 = ok, 0 = sem memoria ou estouro de tamanho */
+static inline int vc_garantir(VetorCrescente *v, size_t necessaria) {
+    void *novo = vc_crescer(v->dados, &v->capacidade, necessaria, v->tam_elem, v->fator);
+    if (!novo) return 0;
+    v->dados = novo;
+    return 1;
+}
+
+/* Copia o elemento para o fim do vetor; 1 = ok, 0 = sem memoria */
+static inline int vc_inserir(VetorCrescente *v, const void *elem) {
+    if (v->tamanho == SIZE_MAX || !vc_garantir(v, v->tamanho + 1)) return 0;
+    memcpy((char *)v->dados + v->tamanho * v->tam_elem, elem, v->tam_elem);
+    v->tamanho++;
+    return 1;
+}
+
+/* Remove o elemento idx preservando a ordem dos demais */
+static inline void vc_remover(VetorCrescente *v, size_t idx) {
+    if (idx >= v->tamanho) return;
+    char *base = (char *)v->dados;
+    memmove(base + idx * v->tam_elem, base + (idx + 1) * v->tam_elem, (v->tamanho - idx - 1) * v->tam_elem);
+    v->tamanho--;
+    v->dados = vc_encolher(v->dados, &v->capacidade, v->tamanho, v->tam_elem, 0);
+}
+
+static inline void vc_liberar(VetorCrescente *v) {
+    free(v->dados);
+    v->dados = NULL;
+    v->tamanho = v->capacidade = 0;
+}
+
+#endif /* VETOR_CRESCENTE_H */
@@ -0,0 +1,276 @@
+/*
+ * vetor_persistente.h
+ *
+ * Vetor persistente (versoes imutaveis com compartilhamento estrutural) e
+ * a pilha de desfazer/refazer construida sobre ele.
+ *  - cada versao e uma arvore treap indexada por posicao; inserir ou remover
+ *    na posicao i copia so o caminho ate i (O(log n) nos esperados), o resto
+ *    da arvore e compartilhado com as versoes anteriores
+ *  - tirar um snapshot custa O(1): so incrementa o contador da raiz
+ *  - nos sao liberados por contagem de referencias quando nenhuma versao
+ *    aponta mais para eles
+ *
+ * Uso:
+ *   HistoricoPersistente h; hist_init(&h, sizeof(Item), 64);
+ *   hist_registrar(&h); vp_remover(&h.atual, idx);   // antes de cada mudanca
+ *   if (hist_desfazer(&h)) vp_copiar_para(&h.atual, destino);
+ *   hist_liberar(&h);
+ */
+#ifndef VETOR_PERSISTENTE_H
+#define VETOR_PERSISTENTE_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "vetor_crescente.h"
+
+typedef struct VpNo {
+    struct VpNo *esq, *dir;
+    size_t tamanho;        /* nos na subarvore */
+    uint32_t prioridade;   /* heap da treap (maior em cima) */
+    unsigned refs;         /* versoes/nos que apontam para este */
+    unsigned char dados[]; /* o elemento (tam_elem bytes) */
+} VpNo;
+
+typedef struct {
+    VpNo *raiz;
+    size_t tam_elem;
+} VetorPersistente;
+
+/* Contadores de custo: nos alocados por copia de caminho e vivos no momento */
+static size_t vp_nos_copiados = 0, vp_nos_vivos = 0;
+
+static inline uint32_t vp_sortear(void) {
+    static uint32_t estado = 2463534242u; /* xorshift32: deterministico entre execucoes */
+    estado ^= estado << 13;
+    estado ^= estado >> 17;
+    estado ^= estado << 5;
+    return estado;
+}
+
+static inline size_t vp_tam(const VpNo *n) { return n ? n->tamanho : 0; }
+
+static inline void vp_atualizar(VpNo *n) { n->tamanho = 1 + vp_tam(n->esq) + vp_tam(n->dir); }
+
+static inline VpNo *vp_reter(VpNo *n) { if (n) n->refs++; return n; }
+
+static inline VpNo *vp_novo_no(const void *elem, size_t tam_elem) {
+    VpNo *n = malloc(sizeof(VpNo) + tam_elem);
+    if (!n) { fprintf(stderr, "Memoria insuficiente para o historico.\n"); exit(1); }
+    n->esq = n->dir = NULL;
+    n->tamanho = 1;
+    n->prioridade = vp_sortear();
+    n->refs = 1;
+    memcpy(n->dados, elem, tam_elem);
+    vp_nos_vivos++;
+    return n;
+}
+
+/* Solta uma referencia; libera a subarvore que ficar sem dono */
+static inline void vp_soltar(VpNo *n) {
+    while (n && --n->refs == 0) {
+        VpNo *dir = n->dir;
+        vp_soltar(n->esq);
+        free(n);
+        vp_nos_vivos--;
+        n = dir; /* cauda iterativa: so a esquerda usa a pilha */
+    }
+}
+
+/*
+ * Devolve um no que pode ser alterado no lugar. Se 'n' e compartilhado com
+ * outra versao, faz a copia (filhos passam a ter um dono a mais) e solta 'n'.
+ */
+static inline VpNo *vp_exclusivo(VpNo *n, size_t tam_elem) {
+    if (n->refs == 1) return n;
+    VpNo *c = vp_novo_no(n->dados, tam_elem);
+    c->prioridade = n->prioridade;
+    c->esq = vp_reter(n->esq);
+    c->dir = vp_reter(n->dir);
+    c->tamanho = n->tamanho;
+    n->refs--;
+    vp_nos_copiados++;
+    return c;
+}
+
+/* Divide t (referencia consumida) em [0, k) e [k, n) */
+static inline void vp_dividir(VpNo *t, size_t k, size_t tam_elem, VpNo **a, VpNo **b) {
+    if (!t) { *a = *b = NULL; return; }
+    t = vp_exclusivo(t, tam_elem);
+    if (k <= vp_tam(t->esq)) {
+        VpNo *resto;
+        vp_dividir(t->esq, k, tam_elem, a, &resto);
+        t->esq = resto;
+        vp_atualizar(t);
+        *b = t;
+    } else {
+        VpNo *resto;
+        vp_dividir(t->dir, k - vp_tam(t->esq) - 1, tam_elem, &resto, b);
+        t->dir = resto;
+        vp_atualizar(t);
+        *a = t;
+    }
+}
+
+/* Concatena a e b (referencias consumidas) */
+static inline VpNo *vp_juntar(VpNo *a, VpNo *b, size_t tam_elem) {
+    if (!a) return b;
+    if (!b) return a;
+    if (a->prioridade >= b->prioridade) {
+        a = vp_exclusivo(a, tam_elem);
+        a->dir = vp_juntar(a->dir, b, tam_elem);
+        vp_atualizar(a);
+        return a;
+    }
+    b = vp_exclusivo(b, tam_elem);
+    b->esq = vp_juntar(a, b->esq, tam_elem);
+    vp_atualizar(b);
+    return b;
+}
+
+static inline void vp_init(VetorPersistente *v, size_t tam_elem) {
+    v->raiz = NULL;
+    v->tam_elem = tam_elem;
+}
+
+static inline size_t vp_tamanho(const VetorPersistente *v) { return vp_tam(v->raiz); }
+
+/* Nova referencia para a mesma versao: O(1) */
+static inline VetorPersistente vp_snapshot(const VetorPersistente *v) {
+    VetorPersistente s = { vp_reter(v->raiz), v->tam_elem };
+    return s;
+}
+
+static inline void vp_liberar(VetorPersistente *v) {
+    vp_soltar(v->raiz);
+    v->raiz = NULL;
+}
+
+/* Insere elem na posicao idx (idx == tamanho acrescenta no fim) */
+static inline void vp_inserir(VetorPersistente *v, size_t idx, const void *elem) {
+    VpNo *a, *b;
+    if (idx > vp_tamanho(v)) idx = vp_tamanho(v);
+    vp_dividir(v->raiz, idx, v->tam_elem, &a, &b);
+    VpNo *n = vp_novo_no(elem, v->tam_elem);
+    v->raiz = vp_juntar(vp_juntar(a, n, v->tam_elem), b, v->tam_elem);
+}
+
+/* Remove a posicao idx preservando a ordem dos demais */
+static inline void vp_remover(VetorPersistente *v, size_t idx) {
+    if (idx >= vp_tamanho(v)) return;
+    VpNo *a, *resto, *meio, *b;
+    vp_dividir(v->raiz, idx, v->tam_elem, &a, &resto);
+    vp_dividir(resto, 1, v->tam_elem, &meio, &b);
+    vp_soltar(meio);
+    v->raiz = vp_juntar(a, b, v->tam_elem);
+}
+
+/* Desce a prioridade ate respeitar o heap (troca valores, nao nos) */
+static inline void vp_heapificar(VpNo *n) {
+    for (;;) {
+        VpNo *maior = n;
+        if (n->esq && n->esq->prioridade > maior->prioridade) maior = n->esq;
+        if (n->dir && n->dir->prioridade > maior->prioridade) maior = n->dir;
+        if (maior == n) return;
+        uint32_t p = n->prioridade; n->prioridade = maior->prioridade; maior->prioridade = p;
+        n = maior;
+    }
+}
+
+static inline VpNo *vp_construir(const unsigned char *dados, size_t n, size_t tam_elem) {
+    if (n == 0) return NULL;
+    size_t meio = n / 2;
+    VpNo *r = vp_novo_no(dados + meio * tam_elem, tam_elem);
+    r->esq = vp_construir(dados, meio, tam_elem);
+    r->dir = vp_construir(dados + (meio + 1) * tam_elem, n - meio - 1, tam_elem);
+    vp_atualizar(r);
+    vp_heapificar(r);
+    return r;
+}
+
+/*
+ * Substitui a versao atual por uma nova com o conteudo de 'dados' em O(n)
+ * (usado quando a operacao reescreve o vetor inteiro, como ordenar). A
+ * versao anterior continua intacta para quem tiver um snapshot dela.
+ */
+static inline void vp_carregar(VetorPersistente *v, const void *dados, size_t n) {
+    VpNo *nova = vp_construir(dados, n, v->tam_elem);
+    vp_soltar(v->raiz);
+    v->raiz = nova;
+}
+
+static inline size_t vp_copiar_no(const VpNo *n, unsigned char *destino, size_t tam_elem) {
+    size_t k = 0;
+    while (n) {
+        k += vp_copiar_no(n->esq, destino + k * tam_elem, tam_elem);
+        memcpy(destino + k * tam_elem, n->dados, tam_elem);
+        k++;
+        n = n->dir;
+    }
+    return k;
+}
+
+/* Copia a versao em ordem para 'destino' (espaco para vp_tamanho elementos) */
+static inline void vp_copiar_para(const VetorPersistente *v, void *destino) {
+    vp_copiar_no(v->raiz, destino, v->tam_elem);
+}
+
+/* ---------------- Desfazer / refazer ---------------- */
+
+typedef struct {
+    VetorPersistente atual;
+    VetorCrescente desfazer; /* pilhas de VetorPersistente (topo no fim) */
+    VetorCrescente refazer;
+    size_t limite;           /* versoes guardadas para desfazer */
+} HistoricoPersistente;
+
+static inline void hist_init(HistoricoPersistente *h, size_t tam_elem, size_t limite) {
+    vp_init(&h->atual, tam_elem);
+    vc_init(&h->desfazer, sizeof(VetorPersistente));
+    vc_init(&h->refazer, sizeof(VetorPersistente));
+    h->limite = limite ? limite : 1;
+}
+
+static inline void hist_esvaziar(VetorCrescente *pilha) {
+    VetorPersistente *p = VC_ITENS(pilha, VetorPersistente);
+    for (size_t i = 0; i < pilha->tamanho; i++) vp_liberar(&p[i]);
+    pilha->tamanho = 0;
+}
+
+/* Guarda a versao atual antes de uma mudanca; a proxima operacao copia so o caminho */
+static inline void hist_registrar(HistoricoPersistente *h) {
+    hist_esvaziar(&h->refazer);
+    if (h->desfazer.tamanho == h->limite) {
+        vp_liberar(&VC_ITENS(&h->desfazer, VetorPersistente)[0]);
+        vc_remover(&h->desfazer, 0);
+    }
+    VetorPersistente s = vp_snapshot(&h->atual);
+    if (!vc_inserir(&h->desfazer, &s)) vp_liberar(&s); /* sem memoria: so perde o desfazer */
+}
+
+static inline int hist_trocar(VetorCrescente *origem, VetorCrescente *destino, VetorPersistente *atual) {
+    if (origem->tamanho == 0) return 0;
+    if (!vc_inserir(destino, atual)) return 0;
+    *atual = VC_ITENS(origem, VetorPersistente)[--origem->tamanho];
+    return 1;
+}
+
+/* 1 = voltou uma versao; 0 = nada para desfazer */
+static inline int hist_desfazer(HistoricoPersistente *h) {
+    return hist_trocar(&h->desfazer, &h->refazer, &h->atual);
+}
+
+static inline int hist_refazer(HistoricoPersistente *h) {
+    return hist_trocar(&h->refazer, &h->desfazer, &h->atual);
+}
+
+static inline void hist_liberar(HistoricoPersistente *h) {
+    hist_esvaziar(&h->desfazer);
+    hist_esvaziar(&h->refazer);
+    vc_liberar(&h->desfazer);
+    vc_liberar(&h->refazer);
+    vp_liberar(&h->atual);
+}
+
+#endif /* VETOR_PERSISTENTE_H */